@@ -0,0 +1,77 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+
+namespace tactile {
+
+/// size of a cache line, used to align and pad data accessed in hot loops
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/// round n up to the next multiple of alignment (which needs to be a power of two)
+constexpr size_t alignUp(size_t n, size_t alignment)
+{
+	return (n + alignment - 1) & ~(alignment - 1);
+}
+
+/// STL allocator returning memory aligned to (at least) a cache line
+template <typename T, size_t Alignment = CACHE_LINE_SIZE>
+class AlignedAllocator {
+public:
+	using value_type = T;
+	template <typename U>
+	struct rebind
+	{
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	AlignedAllocator() = default;
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment> & /*unused*/) {}
+
+	T *allocate(size_t n)
+	{
+		void *p = nullptr;
+		if (posix_memalign(&p, Alignment, alignUp(n * sizeof(T), Alignment)) != 0)
+			throw std::bad_alloc();
+		return static_cast<T *>(p);
+	}
+	void deallocate(T *p, size_t /*unused*/) { free(p); }
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U, Alignment> & /*unused*/) const
+	{
+		return true;
+	}
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment> & /*unused*/) const
+	{
+		return false;
+	}
+};
+
+}  // namespace tactile
@@ -0,0 +1,46 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "Calibration.h"
+#include <math.h>
+
+namespace tactile {
+
+void Calibration::map(const float *in, float *out, size_t n) const
+{
+	for (size_t i = 0; i < n; ++i)
+		out[i] = isfinite(in[i]) ? map(in[i]) : in[i];
+}
+
+void Calibration::map(const uint16_t *in, float *out, size_t n) const
+{
+	for (size_t i = 0; i < n; ++i)
+		out[i] = map(float(in[i]));
+}
+
+void Calibration::map(const int16_t *in, float *out, size_t n) const
+{
+	for (size_t i = 0; i < n; ++i)
+		out[i] = map(float(in[i]));
+}
+
+}  // namespace tactile
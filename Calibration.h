@@ -23,6 +23,8 @@
 #pragma once
 
 #include "Range.h"
+#include <stddef.h>
+#include <stdint.h>
 
 namespace tactile {
 
@@ -32,6 +34,11 @@ public:
 	virtual ~Calibration(){};
 
 	virtual float map(float) const = 0;
+	/// map n values from in to out (which may alias), passing through non-finite values
+	virtual void map(const float *in, float *out, size_t n) const;
+	/// map n raw integer (ADC) codes from in to out
+	virtual void map(const uint16_t *in, float *out, size_t n) const;
+	virtual void map(const int16_t *in, float *out, size_t n) const;
 	virtual Range input_range() const = 0;
 	virtual Range output_range() const = 0;
 };
@@ -0,0 +1,190 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "CalibrationBank.h"
+#include "PieceWiseLinearCalib.h"
+#include <assert.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#ifdef HAVE_YAML
+#include <yaml-cpp/yaml.h>
+#endif
+
+namespace tactile {
+
+void CalibrationBank::resize(size_t n)
+{
+	if (vCurves.empty()) {
+		vCurves.push_back(nullptr);
+		vRefs.push_back(0);
+	}
+	if (n < vIndices.size()) set(n, vIndices.size(), 0);  // release calibrations of removed taxels
+	vRefs[0] += n - vIndices.size();
+	vIndices.resize(n, 0);
+	bRunsValid = false;
+}
+
+void CalibrationBank::reserve(size_t n)
+{
+	vIndices.reserve(n);
+	vRuns.reserve(n);  // at most one run per taxel
+}
+
+void CalibrationBank::clear()
+{
+	vCurves.resize(1);
+	vRefs.assign(1, vIndices.size());
+	vFree.clear();
+	std::fill(vIndices.begin(), vIndices.end(), 0);
+	bRunsValid = false;
+}
+
+CalibrationBank::Index CalibrationBank::add(const std::shared_ptr<Calibration> &c)
+{
+	auto it = std::find(vCurves.begin(), vCurves.end(), c);
+	if (it != vCurves.end()) return it - vCurves.begin();
+	if (!vFree.empty()) {
+		const Index index = vFree.back();
+		vFree.pop_back();
+		vCurves[index] = c;
+		return index;
+	}
+	if (vCurves.size() > std::numeric_limits<Index>::max())
+		throw std::length_error("too many distinct calibrations");
+	vCurves.push_back(c);
+	vRefs.push_back(0);
+	return vCurves.size() - 1;
+}
+
+void CalibrationBank::release(Index index)
+{
+	vCurves[index].reset();
+	vFree.push_back(index);
+}
+
+void CalibrationBank::set(size_t first, size_t last, Index index)
+{
+	assert(first <= last && last <= vIndices.size() && index < vCurves.size());
+	// count new references first, such that reassigning the same index doesn't release it
+	vRefs[index] += last - first;
+	for (auto it = vIndices.begin() + first, end = vIndices.begin() + last; it != end; ++it) {
+		if (--vRefs[*it] == 0 && *it != 0) release(*it);
+		*it = index;
+	}
+	bRunsValid = false;
+}
+
+const std::vector<CalibrationBank::Run> &CalibrationBank::runs()
+{
+	if (bRunsValid) return vRuns;
+	vRuns.clear();
+	for (size_t i = 0, end; i < vIndices.size(); i = end) {
+		for (end = i + 1; end < vIndices.size() && vIndices[end] == vIndices[i]; ++end)
+			;
+		vRuns.push_back(Run{ i, end, vIndices[i] });
+	}
+	bRunsValid = true;
+	return vRuns;
+}
+
+std::vector<CalibrationBank::Run>::const_iterator CalibrationBank::findRun(size_t taxel)
+{
+	const std::vector<Run> &runs = this->runs();
+	// first run ending after taxel
+	return std::upper_bound(runs.begin(), runs.end(), taxel,
+	                        [](size_t taxel, const Run &run) { return taxel < run.end; });
+}
+
+const std::string NO_YAML_SUPPORT("compiled without YAML support");
+void CalibrationBank::load(const YAML::Node &node, const std::string &sBaseDir)
+{
+#ifdef HAVE_YAML
+	// calibration curves, given inline or as file name (relative to sBaseDir)
+	// Each curve holds a reference until all taxels are assigned, such that curves replaced by
+	// later entries aren't released (and their indices reused) while still being referred to.
+	std::map<std::string, Index> curves;
+	auto unref = [this, &curves]() {
+		for (const auto &curve : curves)
+			if (--vRefs[curve.second] == 0) release(curve.second);
+	};
+	try {
+		for (YAML::const_iterator it = node["curves"].begin(); it != node["curves"].end(); ++it) {
+			PieceWiseLinearCalib::CalibrationMap values;
+			if (it->second.IsScalar()) {
+				std::string sFile = it->second.as<std::string>();
+				if (!sBaseDir.empty() && sFile[0] != '/') sFile = sBaseDir + "/" + sFile;
+				values = PieceWiseLinearCalib::load(sFile);
+			} else {
+				values = PieceWiseLinearCalib::load(it->second);
+			}
+			const Index index = add(std::make_shared<PieceWiseLinearCalib>(values));
+			++vRefs[index];
+			curves[it->first.as<std::string>()] = index;
+		}
+
+		// assignment of taxels to curves:
+		// either an inclusive range [first, last] or a list of indices
+		for (const YAML::Node &entry : node["taxels"]) {
+			auto curve = curves.find(entry["curve"].as<std::string>());
+			if (curve == curves.end())
+				throw std::runtime_error("unknown calibration curve: " +
+				                         entry["curve"].as<std::string>());
+
+			std::vector<std::pair<size_t, size_t>> ranges;
+			if (entry["range"]) {
+				const YAML::Node &range = entry["range"];
+				ranges.emplace_back(range[0].as<size_t>(), range[1].as<size_t>() + 1);
+			}
+			for (const YAML::Node &index : entry["indices"])
+				ranges.emplace_back(index.as<size_t>(), index.as<size_t>() + 1);
+
+			for (const auto &range : ranges) {
+				if (range.second > size()) resize(range.second);
+				set(range.first, range.second, curve->second);
+			}
+		}
+	} catch (...) {
+		unref();
+		throw;
+	}
+	// release curves not referred to by any taxel
+	unref();
+#else
+	(void)node;
+	(void)sBaseDir;
+	throw std::runtime_error(NO_YAML_SUPPORT);
+#endif
+}
+
+void CalibrationBank::load(const std::string &sYAMLFile)
+{
+#ifdef HAVE_YAML
+	const size_t pos = sYAMLFile.rfind('/');
+	load(YAML::LoadFile(sYAMLFile), pos == std::string::npos ? "" : sYAMLFile.substr(0, pos));
+#else
+	throw std::runtime_error(NO_YAML_SUPPORT);
+#endif
+}
+
+}  // namespace tactile
@@ -0,0 +1,118 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "Calibration.h"
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace YAML {
+class Node;
+}
+
+namespace tactile {
+
+/* Set of distinct calibrations shared by the taxels of an array.
+   Each taxel refers to its calibration by a compact index into the bank (0 = uncalibrated).
+   Consecutive taxels sharing the same calibration are grouped into runs,
+   such that a whole run can be calibrated with a single batch call.
+   Calibrations are reference-counted by their taxels: once no taxel refers to a calibration
+   anymore, it is released and its index is recycled by subsequent calls to add().
+ */
+class CalibrationBank {
+public:
+	using Index = uint16_t;
+	struct Run
+	{
+		size_t begin, end;  // taxel range [begin, end)
+		Index index;
+	};
+
+	CalibrationBank(size_t n = 0) { resize(n); }
+
+	/// number of taxels
+	size_t size() const { return vIndices.size(); }
+	/// resize to n taxels, keeping the calibration of existing ones
+	void resize(size_t n);
+	/// reserve memory for n taxels, such that resizing up to n taxels
+	/// (and rebuilding their runs) doesn't allocate
+	void reserve(size_t n);
+	/// is any taxel calibrated?
+	bool empty() const { return vRefs[0] == vIndices.size(); }
+	/// remove all calibrations
+	void clear();
+
+	/// number of distinct calibrations held (including the null calibration at index 0)
+	size_t numCurves() const { return vCurves.size() - vFree.size(); }
+	/// retrieve calibration with given index
+	const std::shared_ptr<Calibration> &curve(Index index) const { return vCurves[index]; }
+	/// add calibration to bank (if not yet present) and return its index,
+	/// which remains valid until the calibration isn't referenced by any taxel anymore
+	Index add(const std::shared_ptr<Calibration> &c);
+
+	/// calibration index of given taxel
+	Index index(size_t taxel) const { return vIndices[taxel]; }
+	/// calibration of given taxel
+	const std::shared_ptr<Calibration> &get(size_t taxel) const { return vCurves[vIndices[taxel]]; }
+	/// assign calibration to given taxel
+	void set(size_t taxel, const std::shared_ptr<Calibration> &c) { set(taxel, taxel + 1, add(c)); }
+	/// assign calibration index to taxels [first, last)
+	void set(size_t first, size_t last, Index index);
+
+	/// call fn(begin, end, calib) for all runs of calibrated taxels within [start, start+count),
+	/// passing taxel indices relative to start
+	template <typename Function>
+	void forEachRun(size_t start, size_t count, Function fn)
+	{
+		const std::vector<Run> &runs = this->runs();
+		const size_t end = start + count;
+		for (auto it = findRun(start); it != runs.end() && it->begin < end; ++it) {
+			if (it->index == 0) continue;  // uncalibrated
+			fn(std::max(it->begin, start) - start, std::min(it->end, end) - start,
+			   vCurves[it->index].get());
+		}
+	}
+
+	/// runs of taxels sharing the same calibration, rebuilt lazily after changes
+	const std::vector<Run> &runs();
+
+	/// load bank from YAML file, mapping taxel ranges to calibration curves
+	void load(const std::string &sYAMLFile);
+	void load(const YAML::Node &node, const std::string &sBaseDir = "");
+
+private:
+	std::vector<Run>::const_iterator findRun(size_t taxel);
+	void release(Index index);
+
+	std::vector<std::shared_ptr<Calibration>> vCurves;  // distinct calibrations, [0] = nullptr
+	std::vector<size_t> vRefs;                          // number of taxels per calibration
+	std::vector<Index> vFree;                           // released indices for reuse
+	std::vector<Index> vIndices;                        // calibration index per taxel
+	std::vector<Run> vRuns;                             // runs of taxels, lazily updated
+	bool bRunsValid = false;
+};
+
+}  // namespace tactile
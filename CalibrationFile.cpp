@@ -0,0 +1,142 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "CalibrationFile.h"
+#include "AlignedAllocator.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <stdexcept>
+
+namespace tactile {
+
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+CalibrationFile::CalibrationFile(const std::string &sFile)
+{
+	int fd = open(sFile.c_str(), O_RDONLY);
+	if (fd < 0) throw std::runtime_error("failed to open " + sFile);
+	struct stat st;
+	if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(Header)) {
+		close(fd);
+		throw std::runtime_error("invalid calibration file " + sFile);
+	}
+	const size_t bytes = st.st_size;
+	void *data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) throw std::runtime_error("failed to map " + sFile);
+	pMapping.reset(data, [bytes](const void *p) { munmap(const_cast<void *>(p), bytes); });
+
+	header = static_cast<const Header *>(data);
+	if (header->magic != MAGIC) throw std::runtime_error("not a calibration file: " + sFile);
+	if (header->byteOrder != BYTE_ORDER_MARK)
+		throw std::runtime_error("incompatible byte order: " + sFile);
+	if (header->version != VERSION)
+		throw std::runtime_error("unsupported calibration file version: " + sFile);
+
+	// validate that all curves are within the file,
+	// comparing against the available bytes before adding or multiplying untrusted sizes
+	const size_t headerSize = alignUp(sizeof(Header), CACHE_LINE_SIZE);
+	if (bytes < headerSize || header->numCurves > (bytes - headerSize) / sizeof(CurveHeader))
+		throw std::runtime_error("truncated calibration file: " + sFile);
+	curves = reinterpret_cast<const CurveHeader *>(static_cast<const char *>(data) + headerSize);
+	for (size_t i = 0; i < header->numCurves; ++i) {
+		const CurveHeader &c = curves[i];
+		if (c.numKnots < 2 || c.offset % sizeof(float) != 0 || c.offset > bytes ||
+		    PieceWiseLinearCalib::compiledSize(c.numKnots) > (bytes - c.offset) / sizeof(float))
+			throw std::runtime_error("truncated calibration file: " + sFile);
+	}
+}
+
+std::string CalibrationFile::name(size_t i) const
+{
+	return std::string(curves[i].name, strnlen(curves[i].name, sizeof(curves[i].name)));
+}
+
+std::shared_ptr<PieceWiseLinearCalib> CalibrationFile::curve(size_t i) const
+{
+	const CurveHeader &c = curves[i];
+	auto result = std::make_shared<PieceWiseLinearCalib>();
+	result->pMapping = pMapping;
+	result->fInvStep = c.invStep;
+	result->range = Range(c.outMin, c.outMax);
+	result->bind(reinterpret_cast<const float *>(static_cast<const char *>(pMapping.get()) + c.offset),
+	             c.numKnots);
+	return result;
+}
+
+std::shared_ptr<PieceWiseLinearCalib> CalibrationFile::curve(const std::string &sName) const
+{
+	for (size_t i = 0; i < size(); ++i) {
+		if (name(i) == sName) return curve(i);
+	}
+	return nullptr;
+}
+
+void CalibrationFile::save(const std::string &sFile, const std::vector<NamedCurve> &curves)
+{
+	Header header = { MAGIC, VERSION, BYTE_ORDER_MARK, uint32_t(curves.size()) };
+	std::vector<CurveHeader> headers(curves.size());
+	std::vector<PieceWiseLinearCalib> compiled(curves.size());
+
+	size_t offset = alignUp(sizeof(Header), CACHE_LINE_SIZE);
+	offset = alignUp(offset + curves.size() * sizeof(CurveHeader), CACHE_LINE_SIZE);
+	for (size_t i = 0; i < curves.size(); ++i) {
+		if (curves[i].first.size() >= sizeof(headers[i].name))
+			throw std::invalid_argument("curve name too long: " + curves[i].first);
+		if (curves[i].second.size() < 2)
+			throw std::invalid_argument("curve requires at least two knots: " + curves[i].first);
+		compiled[i].init(curves[i].second);
+
+		CurveHeader &h = headers[i];
+		memset(&h, 0, sizeof(h));
+		strncpy(h.name, curves[i].first.c_str(), sizeof(h.name) - 1);
+		h.offset = offset;
+		h.numKnots = compiled[i].n;
+		h.invStep = compiled[i].fInvStep;
+		h.outMin = compiled[i].range.min();
+		h.outMax = compiled[i].range.max();
+		offset = alignUp(offset + compiled[i].vStorage.size() * sizeof(float), CACHE_LINE_SIZE);
+	}
+
+	std::ofstream file(sFile, std::ios::binary | std::ios::trunc);
+	auto pad = [&file]() {
+		const char zeros[CACHE_LINE_SIZE] = {};
+		const size_t pos = file.tellp();
+		file.write(zeros, alignUp(pos, CACHE_LINE_SIZE) - pos);
+	};
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	pad();
+	file.write(reinterpret_cast<const char *>(headers.data()), headers.size() * sizeof(CurveHeader));
+	pad();
+	for (const auto &c : compiled) {
+		file.write(reinterpret_cast<const char *>(c.vStorage.data()),
+		           c.vStorage.size() * sizeof(float));
+		pad();
+	}
+	if (!file) throw std::runtime_error("failed to write " + sFile);
+}
+
+}  // namespace tactile
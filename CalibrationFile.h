@@ -0,0 +1,83 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "PieceWiseLinearCalib.h"
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tactile {
+
+/* Versioned binary container of compiled PieceWiseLinearCalib curves.
+   The file is memory-mapped and the curves refer to the mapped arrays in place,
+   i.e. opening a file neither parses nor allocates per knot.
+
+   Layout (native byte order, all sections aligned to 64 bytes):
+   - Header
+   - CurveHeader[numCurves]
+   - per curve: keys[n+1] (incl. +inf sentinel), values[n], slopes[n]
+ */
+class CalibrationFile {
+public:
+	static const uint32_t MAGIC = 0x4c414354;  // "TCAL"
+	static const uint32_t VERSION = 1;
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t byteOrder;  // 0x01020304 in writer's byte order
+		uint32_t numCurves;
+	};
+	struct CurveHeader
+	{
+		char name[40];    // zero-terminated
+		uint64_t offset;  // byte offset of compiled arrays from begin of file
+		uint32_t numKnots;
+		float invStep;
+		float outMin, outMax;
+	};
+
+	/// memory-map given file, throws std::runtime_error on failure
+	explicit CalibrationFile(const std::string &sFile);
+
+	size_t size() const { return header->numCurves; }
+	std::string name(size_t i) const;
+	/// curve with given index, referring to the mapped memory
+	std::shared_ptr<PieceWiseLinearCalib> curve(size_t i) const;
+	/// curve with given name (nullptr if not found)
+	std::shared_ptr<PieceWiseLinearCalib> curve(const std::string &sName) const;
+
+	using NamedCurve = std::pair<std::string, PieceWiseLinearCalib::CalibrationMap>;
+	/// write given curves into binary file
+	static void save(const std::string &sFile, const std::vector<NamedCurve> &curves);
+
+private:
+	std::shared_ptr<const void> pMapping;
+	const Header *header;
+	const CurveHeader *curves;
+};
+
+}  // namespace tactile
@@ -0,0 +1,153 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "AlignedAllocator.h"
+#include "TactileValueArray.h"
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace tactile {
+
+/* Bounded, lock-free single-producer/single-consumer ring of preallocated frames,
+   handing raw frames from a driver thread to the filter thread without blocking either.
+   If the ring is full, the producer drops the new frame and counts it.
+   Slots are cache-line aligned and producer and consumer indices live on separate cache lines.
+ */
+template <typename T>
+class FrameRing {
+public:
+	/// create ring of capacity slots, each holding a frame of frameSize values
+	FrameRing(size_t frameSize, size_t capacity)
+	  : nFrameSize(frameSize)
+	  , nStride(alignUp(frameSize * sizeof(T), CACHE_LINE_SIZE) / sizeof(T))
+	  , nCapacity(capacity)
+	  , vSlots(nStride * capacity)
+	{
+		static_assert(CACHE_LINE_SIZE % sizeof(T) == 0, "frame values need to tile cache lines");
+	}
+
+	size_t frameSize() const { return nFrameSize; }
+	size_t capacity() const { return nCapacity; }
+	/// number of frames available to the consumer (approximate if called by the producer)
+	size_t size() const
+	{
+		return producer.head.load(std::memory_order_acquire) -
+		       consumer.tail.load(std::memory_order_acquire);
+	}
+
+	// ---- producer interface ----
+	/// slot to write the next frame into, nullptr if the ring is full (counting a dropped frame)
+	T *beginWrite()
+	{
+		const size_t head = producer.head.load(std::memory_order_relaxed);
+		if (head - producer.cachedTail == nCapacity) {
+			// refresh cached tail only when ring appears full: avoids cache-line ping-pong
+			producer.cachedTail = consumer.tail.load(std::memory_order_acquire);
+			if (head - producer.cachedTail == nCapacity) {
+				if (!producer.bOverflow) producer.overflows.fetch_add(1, std::memory_order_relaxed);
+				producer.bOverflow = true;
+				producer.dropped.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+		}
+		producer.bOverflow = false;
+		return slot(head);
+	}
+	/// publish frame written into slot returned by beginWrite()
+	void commitWrite()
+	{
+		producer.head.store(producer.head.load(std::memory_order_relaxed) + 1,
+		                    std::memory_order_release);
+	}
+	/// copy frame of frameSize() values into the ring, false if it was dropped
+	bool push(const T *frame)
+	{
+		T *target = beginWrite();
+		if (!target) return false;
+		std::copy_n(frame, nFrameSize, target);
+		commitWrite();
+		return true;
+	}
+
+	/// total number of frames dropped because the ring was full
+	uint64_t dropped() const { return producer.dropped.load(std::memory_order_relaxed); }
+	/// number of overflow events, i.e. sequences of consecutively dropped frames
+	uint64_t overflows() const { return producer.overflows.load(std::memory_order_relaxed); }
+
+	// ---- consumer interface ----
+	/// oldest frame, nullptr if the ring is empty
+	const T *front()
+	{
+		const size_t tail = consumer.tail.load(std::memory_order_relaxed);
+		if (tail == consumer.cachedHead) {
+			consumer.cachedHead = producer.head.load(std::memory_order_acquire);
+			if (tail == consumer.cachedHead) return nullptr;
+		}
+		return slot(tail);
+	}
+	/// release oldest frame returned by front()
+	void pop()
+	{
+		consumer.tail.store(consumer.tail.load(std::memory_order_relaxed) + 1,
+		                    std::memory_order_release);
+	}
+	/// update array (beginning from offset) with all available frames in order of arrival,
+	/// returning the number of frames consumed
+	size_t consume(TactileValueArray &array, ptrdiff_t offset = 0)
+	{
+		size_t count = 0;
+		for (const T *frame; (frame = front()) != nullptr; ++count) {
+			array.updateValues(frame, frame + nFrameSize, offset);
+			pop();
+		}
+		return count;
+	}
+
+private:
+	T *slot(size_t index) { return vSlots.data() + (index % nCapacity) * nStride; }
+
+	const size_t nFrameSize;
+	const size_t nStride;  // frame size rounded up to cache lines
+	const size_t nCapacity;
+	std::vector<T, AlignedAllocator<T>> vSlots;
+
+	// state owned by producer and consumer, padded to separate cache lines
+	struct alignas(CACHE_LINE_SIZE) Producer
+	{
+		std::atomic<size_t> head{ 0 };  // index of next frame to write
+		size_t cachedTail = 0;          // last seen consumer.tail
+		bool bOverflow = false;         // was last frame dropped?
+		std::atomic<uint64_t> dropped{ 0 };
+		std::atomic<uint64_t> overflows{ 0 };
+	} producer;
+	struct alignas(CACHE_LINE_SIZE) Consumer
+	{
+		std::atomic<size_t> tail{ 0 };  // index of next frame to read
+		size_t cachedHead = 0;          // last seen producer.head
+	} consumer;
+};
+
+}  // namespace tactile
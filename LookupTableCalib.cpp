@@ -0,0 +1,86 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "LookupTableCalib.h"
+#include <assert.h>
+#include <math.h>
+
+namespace tactile {
+
+LookupTableCalib::LookupTableCalib(const Calibration &calib, int first, int last)
+{
+	init(calib, first, last);
+}
+
+void LookupTableCalib::init(const Calibration &calib, int first, int last)
+{
+	assert(last > first);
+	this->first = first;
+	table.resize(last - first + 1);
+	range = Range();
+	for (size_t i = 0; i < table.size(); ++i) {
+		table[i] = calib.map(float(first + int(i)));
+		range.update(table[i]);
+	}
+}
+
+float LookupTableCalib::map(float x) const
+{
+	assert(!table.empty());
+	const float fPos = x - first;
+	if (!(fPos > 0)) return table.front();
+	if (fPos >= table.size() - 1) return table.back();
+	const size_t i = size_t(fPos);
+	return table[i] + (fPos - i) * (table[i + 1] - table[i]);
+}
+
+void LookupTableCalib::map(const float *in, float *out, size_t n) const
+{
+	for (size_t i = 0; i < n; ++i)
+		out[i] = isfinite(in[i]) ? LookupTableCalib::map(in[i]) : in[i];
+}
+
+void LookupTableCalib::map(const uint16_t *in, float *out, size_t n) const
+{
+	const float *t = table.data();
+	for (size_t i = 0; i < n; ++i)
+		out[i] = t[index(in[i])];
+}
+
+void LookupTableCalib::map(const int16_t *in, float *out, size_t n) const
+{
+	const float *t = table.data();
+	for (size_t i = 0; i < n; ++i)
+		out[i] = t[index(in[i])];
+}
+
+Range LookupTableCalib::input_range() const
+{
+	return Range(first, first + int(table.size()) - 1);
+}
+
+Range LookupTableCalib::output_range() const
+{
+	return range;
+}
+
+}  // namespace tactile
@@ -0,0 +1,64 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "Calibration.h"
+#include <vector>
+
+namespace tactile {
+
+/* Dense lookup table for integer input codes, e.g. raw values of a 12-bit ADC.
+   The table is precomputed from an arbitrary Calibration for all codes in [first, last],
+   such that integer inputs are calibrated with a single load.
+   Codes outside the range are clipped, float inputs are linearly interpolated.
+ */
+class LookupTableCalib : public Calibration {
+public:
+	LookupTableCalib() {}
+	LookupTableCalib(const Calibration &calib, int first = 0, int last = 4095);
+
+	void init(const Calibration &calib, int first = 0, int last = 4095);
+
+	float map(float x) const override;
+	void map(const float *in, float *out, size_t n) const override;
+	void map(const uint16_t *in, float *out, size_t n) const override;
+	void map(const int16_t *in, float *out, size_t n) const override;
+	Range input_range() const override;
+	Range output_range() const override;
+
+	/// calibrated value of given integer code
+	float operator[](int code) const { return table[index(code)]; }
+
+private:
+	size_t index(int code) const
+	{
+		const unsigned int i = code - first;  // negative values wrap to large ones
+		return i < table.size() ? i : (code < first ? 0 : table.size() - 1);
+	}
+
+	int first = 0;
+	std::vector<float> table;
+	Range range;
+};
+
+}  // namespace tactile
@@ -0,0 +1,79 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "OutputSnapshot.h"
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace tactile {
+
+OutputSnapshot::OutputSnapshot(size_t n, const std::vector<TactileValue::Mode> &modes)
+  : n(n), nStride(TactileState::stride(n)), vModes(modes), seq(0)
+{
+	std::fill(slots, slots + TactileValue::lastMode + 1, -1);
+	vBack.resize(nStride * modes.size());
+	shared.reset(new std::atomic<float>[nStride * modes.size()]);
+	for (size_t k = 0; k < modes.size(); ++k) {
+		slots[modes[k]] = k;
+		outputs.push_back(TactileValueArray::ModeOutput{ modes[k], vBack.data() + k * nStride });
+	}
+	for (size_t i = 0; i < nStride * modes.size(); ++i)
+		shared[i].store(NAN, std::memory_order_relaxed);
+}
+
+void OutputSnapshot::publish(const TactileValueArray &array)
+{
+	assert(array.size() == n);
+	// compute all modes in a single pass, outside of the critical section
+	array.getValues(outputs, n);
+
+	const uint64_t s = seq.load(std::memory_order_relaxed);
+	seq.store(s + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	const float *values = vBack.data();
+	for (size_t i = 0, end = nStride * vModes.size(); i < end; ++i)
+		shared[i].store(values[i], std::memory_order_relaxed);
+	seq.store(s + 2, std::memory_order_release);
+}
+
+uint64_t OutputSnapshot::read(TactileValue::Mode mode, float *values) const
+{
+	if (mode < 0 || mode > TactileValue::lastMode || slots[mode] < 0)
+		throw std::invalid_argument("mode not published: " + TactileValue::getModeName(mode));
+	const std::atomic<float> *source = shared.get() + slots[mode] * nStride;
+	while (true) {
+		const uint64_t before = seq.load(std::memory_order_acquire);
+		if (before & 1) {  // publishing in progress
+			std::this_thread::yield();
+			continue;
+		}
+		for (size_t i = 0; i < n; ++i)
+			values[i] = source[i].load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (seq.load(std::memory_order_relaxed) == before) return before / 2;
+	}
+}
+
+}  // namespace tactile
@@ -0,0 +1,65 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "TactileValueArray.h"
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace tactile {
+
+/* Lock-free snapshots of output modes of a TactileValueArray, protected by a seqlock.
+   The update thread computes the selected modes and publishes them without ever waiting,
+   while any number of reader threads copy a consistent frame of values without taking locks.
+   Readers only retry if they overlap with copying the (precomputed) values into the snapshot.
+ */
+class OutputSnapshot {
+public:
+	/// snapshot of given output modes for an array of n taxels
+	OutputSnapshot(size_t n, const std::vector<TactileValue::Mode> &modes);
+
+	size_t size() const { return n; }
+	const std::vector<TactileValue::Mode> &modes() const { return vModes; }
+	/// number of frames published so far
+	uint64_t frames() const { return seq.load(std::memory_order_acquire) / 2; }
+
+	/// compute output modes of array and publish them (to be called by the update thread only)
+	void publish(const TactileValueArray &array);
+	/// copy latest published values of mode into values[0, size()), returning their frame number
+	/// (0 if nothing was published yet), throws std::invalid_argument if mode isn't published
+	uint64_t read(TactileValue::Mode mode, float *values) const;
+
+private:
+	size_t n;
+	size_t nStride;
+	std::vector<TactileValue::Mode> vModes;
+	int slots[TactileValue::lastMode + 1];  // slot of mode in buffers, -1 if not published
+	std::vector<float, AlignedAllocator<float>> vBack;   // values computed by publish()
+	std::vector<TactileValueArray::ModeOutput> outputs;  // modes computed into vBack
+	std::unique_ptr<std::atomic<float>[]> shared;        // published values
+	std::atomic<uint64_t> seq;  // sequence number, odd while publishing
+};
+
+}  // namespace tactile
@@ -22,6 +22,8 @@
  * ============================================================ */
 #include "PieceWiseLinearCalib.h"
 #include <assert.h>
+#include <math.h>
+#include <algorithm>
 #include <stdexcept>
 #ifdef HAVE_YAML
 #include <yaml-cpp/yaml.h>
@@ -34,33 +36,113 @@ PieceWiseLinearCalib::PieceWiseLinearCalib(const CalibrationMap &values)
 	init(values);
 }
 
+PieceWiseLinearCalib::PieceWiseLinearCalib(const PieceWiseLinearCalib &other)
+{
+	*this = other;
+}
+
+PieceWiseLinearCalib &PieceWiseLinearCalib::operator=(const PieceWiseLinearCalib &other)
+{
+	vStorage = other.vStorage;
+	pMapping = other.pMapping;
+	fInvStep = other.fInvStep;
+	range = other.range;
+	bind(vStorage.empty() ? other.keys : vStorage.data(), other.n);
+	return *this;
+}
+
+void PieceWiseLinearCalib::bind(const float *data, size_t n)
+{
+	this->n = n;
+	keys = data;
+	if (!data) {  // empty calibration
+		values = slopes = nullptr;
+		return;
+	}
+	values = keys + n + 1;
+	slopes = values + n;
+}
+
 void PieceWiseLinearCalib::init(const CalibrationMap &values)
 {
 	assert(values.size() > 1);
-	this->values = values;
+	const size_t n = values.size();
+	vStorage.resize(compiledSize(n));
+	pMapping.reset();
+	bind(vStorage.data(), n);
+
+	float *pKeys = vStorage.data();
+	float *pValues = pKeys + n + 1;
+	float *pSlopes = pValues + n;
 	range = Range();
-	for (const auto &value : values)
+	size_t k = 0;
+	for (const auto &value : values) {
+		pKeys[k] = value.first;
+		pValues[k++] = value.second;
 		range.update(value.second);
+	}
+	for (k = 0; k + 1 < n; ++k)
+		pSlopes[k] = (pValues[k + 1] - pValues[k]) / (pKeys[k + 1] - pKeys[k]);
+	pSlopes[n - 1] = 0;
+	pKeys[n] = INFINITY;  // sentinel
+
+	// use direct indexing if all knots are close to a uniform grid
+	const float fStep = (pKeys[n - 1] - pKeys[0]) / (n - 1);
+	fInvStep = 1.f / fStep;
+	for (k = 1; k < n && fInvStep != 0; ++k) {
+		if (fabs(pKeys[k] - (pKeys[0] + k * fStep)) > 1e-3 * fStep) fInvStep = 0;
+	}
+}
+
+// index of segment [keys[k], keys[k+1]) containing x (which is clipped to the key range)
+inline size_t PieceWiseLinearCalib::segment(float x) const
+{
+	const float *base = keys;
+	if (fInvStep != 0) {
+		// direct indexing, followed by correction of rounding errors
+		size_t k = std::min(size_t((x - keys[0]) * fInvStep), n - 1);
+		k -= (k > 0) & (keys[k] > x);
+		k += keys[k + 1] <= x;
+		return k;
+	}
+	// branch-free binary search for last key <= x
+	for (size_t len = n; len > 1;) {
+		const size_t half = len / 2;
+		base = base[half] <= x ? base + half : base;
+		len -= half;
+	}
+	return base - keys;
+}
+
+inline float PieceWiseLinearCalib::interpolate(float x) const
+{
+	// clip to key range: beyond last knot, the (zero) slope of last knot applies
+	// NaN is clipped to the last knot (as by the former std::map lookup)
+	x = x < keys[n - 1] ? x : keys[n - 1];
+	x = x > keys[0] ? x : keys[0];
+	const size_t k = segment(x);
+	return values[k] + (x - keys[k]) * slopes[k];
 }
 
 float PieceWiseLinearCalib::map(float x) const
 {
-	assert(values.size() > 1);
-	// retrieve first key that is larger than x
-	CalibrationMap::const_iterator next = values.upper_bound(x);
-	// if x is smaller than key range, clip to smallest value
-	if (next == values.begin()) return values.begin()->second;
-	// if x is larger than key range, clip to largest value
-	if (next == values.end()) return values.rbegin()->second;
-	CalibrationMap::const_iterator prev = next;
-	--prev;
-	return prev->second +
-	       (x - prev->first) / (next->first - prev->first) * (next->second - prev->second);
+	assert(n > 1);
+	return interpolate(x);
+}
+
+void PieceWiseLinearCalib::map(const float *in, float *out, size_t n) const
+{
+	assert(this->n > 1);
+	for (size_t i = 0; i < n; ++i) {
+		const float x = in[i];
+		const float y = interpolate(x);
+		out[i] = isfinite(x) ? y : x;
+	}
 }
 
 Range PieceWiseLinearCalib::input_range() const
 {
-	return Range(values.begin()->first, values.rbegin()->first);
+	return Range(keys[0], keys[n - 1]);
 }
 
 Range PieceWiseLinearCalib::output_range() const
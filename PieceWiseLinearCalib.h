@@ -24,6 +24,8 @@
 
 #include "Calibration.h"
 #include <map>
+#include <memory>
+#include <vector>
 #include <string>
 
 namespace YAML {
@@ -32,24 +34,51 @@ class Node;
 
 namespace tactile {
 
+/* Piece-wise linear interpolation between calibration knots (clipping outside the key range).
+   The knots are compiled into flat, sorted arrays of keys, values, and slopes.
+   Segments are found by direct indexing for (nearly) uniformly spaced knots
+   and by a branch-free binary search otherwise.
+   The arrays are either owned or refer to a memory-mapped CalibrationFile.
+ */
 class PieceWiseLinearCalib : public Calibration {
 public:
 	using CalibrationMap = std::map<float, float>;
 
 	PieceWiseLinearCalib() {}
 	PieceWiseLinearCalib(const CalibrationMap &values);
+	PieceWiseLinearCalib(const PieceWiseLinearCalib &other);
+	PieceWiseLinearCalib &operator=(const PieceWiseLinearCalib &other);
 
 	void init(const CalibrationMap &values);
+	using Calibration::map;
 	float map(float x) const override;
+	void map(const float *in, float *out, size_t n) const override;
 	Range input_range() const override;
 	Range output_range() const override;
 
 	static CalibrationMap load(const YAML::Node &node);
 	static CalibrationMap load(const std::string &sYAMLFile);
 
+	/// number of floats required for the compiled arrays of n knots
+	static size_t compiledSize(size_t n) { return 3 * n + 1; }
+
 private:
-	CalibrationMap values;
+	friend class CalibrationFile;
+
+	/// refer to compiled arrays of n knots, stored consecutively in data
+	void bind(const float *data, size_t n);
+	float interpolate(float x) const;
+	size_t segment(float x) const;
+
+	const float *keys = nullptr;    // sorted knot positions, followed by +inf as sentinel
+	const float *values = nullptr;  // values at knots
+	const float *slopes = nullptr;  // slope from knot k to k+1, 0 for last knot
+	size_t n = 0;                   // number of knots
+	float fInvStep = 0;             // inverse knot spacing if knots are uniform, 0 otherwise
 	Range range;
+
+	std::vector<float> vStorage;          // storage of owned arrays
+	std::shared_ptr<const void> pMapping;  // keeps externally stored arrays alive
 };
 
 }  // namespace tactile
@@ -0,0 +1,174 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "StateCheckpoint.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace tactile {
+
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+static const size_t HEADER_SIZE = alignUp(sizeof(StateCheckpoint::Header), CACHE_LINE_SIZE);
+
+static size_t paramsSize(size_t nOverrides)
+{
+	return alignUp(3 * sizeof(float) + nOverrides * sizeof(StateCheckpoint::Override),
+	               CACHE_LINE_SIZE);
+}
+
+size_t StateCheckpoint::size(size_t n, size_t nOverrides)
+{
+	return HEADER_SIZE + TactileState::size(n) * sizeof(float) + paramsSize(nOverrides);
+}
+
+size_t StateCheckpoint::save(const TactileValueArray &array, void *buffer, size_t bytes)
+{
+	const size_t n = array.size();
+	const size_t nOverrides = array.vOverrides.size();
+	const size_t result = size(n, nOverrides);
+	if (bytes < result) throw std::length_error("checkpoint buffer too small");
+
+	char *p = static_cast<char *>(buffer);
+	const Header header = { MAGIC, VERSION, BYTE_ORDER_MARK, TactileState::NUM_FIELDS, n,
+		                     TactileState::stride(n), nOverrides };
+	memset(p, 0, HEADER_SIZE);
+	memcpy(p, &header, sizeof(header));
+	p += HEADER_SIZE;
+
+	const size_t fieldSize = header.stride * sizeof(float);
+	for (size_t f = 0; f < TactileState::NUM_FIELDS; ++f, p += fieldSize) {
+		memcpy(p, array.state.field(TactileState::Field(f)), n * sizeof(float));
+		memset(p + n * sizeof(float), 0, fieldSize - n * sizeof(float));
+	}
+
+	memset(p, 0, paramsSize(nOverrides));
+	const TactileParams &shared = array.params;
+	const float params[3] = { shared.meanLambda, shared.rangeLambda, shared.releaseDecay };
+	memcpy(p, params, sizeof(params));
+	p += sizeof(params);
+	for (const TactileValueArray::Override &o : array.vOverrides) {
+		const Override record = { o.taxel, o.params.meanLambda, o.params.rangeLambda,
+			                       o.params.releaseDecay };
+		memcpy(p, &record, sizeof(record));
+		p += sizeof(record);
+	}
+	return result;
+}
+
+void StateCheckpoint::load(TactileValueArray &array, const void *buffer, size_t bytes)
+{
+	Header header;
+	if (bytes < HEADER_SIZE) throw std::runtime_error("truncated checkpoint");
+	memcpy(&header, buffer, sizeof(header));
+	if (header.magic != MAGIC) throw std::runtime_error("not a checkpoint");
+	if (header.byteOrder != BYTE_ORDER_MARK) throw std::runtime_error("incompatible byte order");
+	if (header.version != VERSION || header.numFields != TactileState::NUM_FIELDS)
+		throw std::runtime_error("unsupported checkpoint version");
+
+	// validate sizes against the available bytes before multiplying them, to avoid overflows
+	size_t available = bytes - HEADER_SIZE;
+	if (header.numTaxels > available / (header.numFields * sizeof(float)))
+		throw std::runtime_error("truncated checkpoint");
+	if (header.stride != TactileState::stride(header.numTaxels))
+		throw std::runtime_error("invalid checkpoint");
+	const size_t fieldsSize = header.numFields * header.stride * sizeof(float);
+	if (fieldsSize > available) throw std::runtime_error("truncated checkpoint");
+	available -= fieldsSize;
+	if (header.numOverrides > available / sizeof(Override) ||
+	    paramsSize(header.numOverrides) > available)
+		throw std::runtime_error("truncated checkpoint");
+
+	const size_t n = header.numTaxels;
+	if (!array.empty() && array.size() != n)
+		throw std::runtime_error("checkpoint refers to different number of taxels");
+	// validate override records before modifying the array
+	const char *records = static_cast<const char *>(buffer) + HEADER_SIZE + fieldsSize +
+	                      3 * sizeof(float);
+	for (size_t k = 0; k < header.numOverrides; ++k) {
+		Override record;
+		memcpy(&record, records + k * sizeof(Override), sizeof(record));
+		if (record.taxel >= n) throw std::runtime_error("invalid checkpoint");
+	}
+
+	if (array.empty()) array.init(n);
+	const char *p = static_cast<const char *>(buffer) + HEADER_SIZE;
+	for (size_t f = 0; f < TactileState::NUM_FIELDS; ++f, p += header.stride * sizeof(float))
+		memcpy(array.state.field(TactileState::Field(f)), p, n * sizeof(float));
+
+	array.clearOverrides();
+	float params[3];
+	memcpy(params, p, sizeof(params));
+	p += sizeof(params);
+	TactileParams shared;
+	shared.meanLambda = params[0];
+	shared.rangeLambda = params[1];
+	shared.releaseDecay = params[2];
+	array.setParameters(shared);
+	for (size_t k = 0; k < header.numOverrides; ++k, p += sizeof(Override)) {
+		Override record;
+		memcpy(&record, p, sizeof(record));
+		TactileParams o;
+		o.meanLambda = record.meanLambda;
+		o.rangeLambda = record.rangeLambda;
+		o.releaseDecay = record.releaseDecay;
+		array.setParameters(record.taxel, o);
+	}
+}
+
+void StateCheckpoint::save(const TactileValueArray &array, const std::string &sFile)
+{
+	std::vector<char> buffer(size(array.size(), array.numOverrides()));
+	save(array, buffer.data(), buffer.size());
+	std::ofstream file(sFile, std::ios::binary | std::ios::trunc);
+	file.write(buffer.data(), buffer.size());
+	if (!file) throw std::runtime_error("failed to write " + sFile);
+}
+
+void StateCheckpoint::load(TactileValueArray &array, const std::string &sFile)
+{
+	int fd = open(sFile.c_str(), O_RDONLY);
+	if (fd < 0) throw std::runtime_error("failed to open " + sFile);
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		throw std::runtime_error("invalid checkpoint " + sFile);
+	}
+	const size_t bytes = st.st_size;
+	void *data = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) throw std::runtime_error("failed to map " + sFile);
+	try {
+		load(array, data, bytes);
+	} catch (const std::runtime_error &e) {
+		munmap(data, bytes);
+		throw std::runtime_error(std::string(e.what()) + ": " + sFile);
+	}
+	munmap(data, bytes);
+}
+
+}  // namespace tactile
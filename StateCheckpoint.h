@@ -0,0 +1,80 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "TactileValueArray.h"
+#include <stdint.h>
+#include <string>
+
+namespace tactile {
+
+/* Versioned binary checkpoint of the filter state of a TactileValueArray (current values, means,
+   ranges, release state, and filter parameters), allowing for warm restarts without re-learning
+   the dynamic range. Calibrations and regions are not part of the checkpoint.
+
+   Layout (native byte order, all sections aligned to 64 bytes):
+   - Header
+   - per TactileState::Field: values[numTaxels], padded to stride floats
+   - shared TactileParams, followed by numOverrides Override records
+   Saving into a caller-provided buffer (e.g. a shared file mapping) doesn't allocate,
+   such that checkpoints can be taken periodically from the real-time thread.
+ */
+class StateCheckpoint {
+public:
+	static const uint32_t MAGIC = 0x504b4354;  // "TCKP"
+	static const uint32_t VERSION = 1;
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t byteOrder;  // 0x01020304 in writer's byte order
+		uint32_t numFields;
+		uint64_t numTaxels;
+		uint64_t stride;  // number of floats per field
+		uint64_t numOverrides;  // number of taxels with own parameters
+	};
+	struct Override
+	{
+		uint32_t taxel;
+		float meanLambda, rangeLambda, releaseDecay;
+	};
+
+	/// number of bytes of a checkpoint of n taxels, nOverrides of them with own parameters
+	static size_t size(size_t n, size_t nOverrides = 0);
+
+	/// write state of array into buffer of given size
+	/// (at least size(array.size(), array.numOverrides()) bytes),
+	/// returning the number of bytes written, throws std::length_error if buffer is too small
+	static size_t save(const TactileValueArray &array, void *buffer, size_t bytes);
+	/// restore state of array from buffer, initializing an empty array
+	/// throws std::runtime_error for invalid checkpoints or a mismatching number of taxels
+	static void load(TactileValueArray &array, const void *buffer, size_t bytes);
+
+	/// write checkpoint of array into file
+	static void save(const TactileValueArray &array, const std::string &sFile);
+	/// restore state of array from (memory-mapped) checkpoint file
+	static void load(TactileValueArray &array, const std::string &sFile);
+};
+
+}  // namespace tactile
@@ -0,0 +1,205 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <iterator>
+
+namespace tactile {
+
+/* Zero-copy views onto sensor values within a packet buffer, e.g. interleaved arrays or values
+   separated by header bytes. Passed to TactileValueArray::updateValues(), elements are read and
+   converted to float in a single pass without de-interleaving into temporary vectors.
+   Elements are read with unaligned loads, thus arbitrary byte offsets and strides are supported.
+ */
+
+/// load an element of type T from a potentially unaligned address
+template <typename T>
+inline T loadUnaligned(const char *p)
+{
+	T value;
+	memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+/// random-access iterator over elements of type T located every stride bytes
+template <typename T>
+class StridedIterator {
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = T;
+	using difference_type = ptrdiff_t;
+	using pointer = const T *;
+	using reference = T;
+
+	StridedIterator(const void *p, size_t stride)
+	  : p(static_cast<const char *>(p)), stride(stride) {}
+
+	T operator*() const { return loadUnaligned<T>(p); }
+	T operator[](difference_type i) const { return *(*this + i); }
+
+	StridedIterator &operator++()
+	{
+		p += stride;
+		return *this;
+	}
+	StridedIterator operator++(int)
+	{
+		StridedIterator result = *this;
+		p += stride;
+		return result;
+	}
+	StridedIterator &operator--()
+	{
+		p -= stride;
+		return *this;
+	}
+	StridedIterator operator--(int)
+	{
+		StridedIterator result = *this;
+		p -= stride;
+		return result;
+	}
+	StridedIterator &operator+=(difference_type i)
+	{
+		p += i * difference_type(stride);
+		return *this;
+	}
+	StridedIterator &operator-=(difference_type i) { return *this += -i; }
+	StridedIterator operator+(difference_type i) const { return StridedIterator(*this) += i; }
+	StridedIterator operator-(difference_type i) const { return StridedIterator(*this) -= i; }
+	friend StridedIterator operator+(difference_type i, const StridedIterator &it) { return it + i; }
+	difference_type operator-(const StridedIterator &other) const
+	{
+		return (p - other.p) / difference_type(stride);
+	}
+	bool operator==(const StridedIterator &other) const { return p == other.p; }
+	bool operator!=(const StridedIterator &other) const { return p != other.p; }
+	bool operator<(const StridedIterator &other) const { return p < other.p; }
+	bool operator>(const StridedIterator &other) const { return p > other.p; }
+	bool operator<=(const StridedIterator &other) const { return p <= other.p; }
+	bool operator>=(const StridedIterator &other) const { return p >= other.p; }
+
+private:
+	const char *p;
+	size_t stride;
+};
+
+/// count elements of type T, starting at base, located every stride bytes
+template <typename T>
+class StridedView {
+public:
+	using const_iterator = StridedIterator<T>;
+
+	StridedView(const void *base, size_t stride, size_t count)
+	  : base(base), stride(stride), count(count) {}
+
+	size_t size() const { return count; }
+	T operator[](size_t i) const { return begin()[i]; }
+	const_iterator begin() const { return const_iterator(base, stride); }
+	const_iterator end() const { return begin() + count; }
+
+private:
+	const void *base;
+	size_t stride;
+	size_t count;
+};
+
+/// random-access iterator over elements base[indices[i]] of type T
+template <typename T, typename Index>
+class IndexedIterator {
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = T;
+	using difference_type = ptrdiff_t;
+	using pointer = const T *;
+	using reference = T;
+
+	IndexedIterator(const void *base, const Index *index)
+	  : base(static_cast<const char *>(base)), index(index) {}
+
+	T operator*() const { return loadUnaligned<T>(base + *index * sizeof(T)); }
+	T operator[](difference_type i) const { return loadUnaligned<T>(base + index[i] * sizeof(T)); }
+
+	IndexedIterator &operator++()
+	{
+		++index;
+		return *this;
+	}
+	IndexedIterator operator++(int) { return IndexedIterator(base, index++); }
+	IndexedIterator &operator--()
+	{
+		--index;
+		return *this;
+	}
+	IndexedIterator operator--(int) { return IndexedIterator(base, index--); }
+	IndexedIterator &operator+=(difference_type i)
+	{
+		index += i;
+		return *this;
+	}
+	IndexedIterator &operator-=(difference_type i)
+	{
+		index -= i;
+		return *this;
+	}
+	IndexedIterator operator+(difference_type i) const { return IndexedIterator(base, index + i); }
+	IndexedIterator operator-(difference_type i) const { return IndexedIterator(base, index - i); }
+	friend IndexedIterator operator+(difference_type i, const IndexedIterator &it) { return it + i; }
+	difference_type operator-(const IndexedIterator &other) const { return index - other.index; }
+	bool operator==(const IndexedIterator &other) const { return index == other.index; }
+	bool operator!=(const IndexedIterator &other) const { return index != other.index; }
+	bool operator<(const IndexedIterator &other) const { return index < other.index; }
+	bool operator>(const IndexedIterator &other) const { return index > other.index; }
+	bool operator<=(const IndexedIterator &other) const { return index <= other.index; }
+	bool operator>=(const IndexedIterator &other) const { return index >= other.index; }
+
+private:
+	const char *base;
+	const Index *index;
+};
+
+/// elements base[indices[i]] of type T for i in [0, count), i.e. a mapping table from taxels
+/// to element positions within a packet
+template <typename T, typename Index = uint16_t>
+class IndexedView {
+public:
+	using const_iterator = IndexedIterator<T, Index>;
+
+	IndexedView(const void *base, const Index *indices, size_t count)
+	  : base(base), indices(indices), count(count) {}
+
+	size_t size() const { return count; }
+	T operator[](size_t i) const { return begin()[i]; }
+	const_iterator begin() const { return const_iterator(base, indices); }
+	const_iterator end() const { return begin() + count; }
+
+private:
+	const void *base;
+	const Index *indices;
+	size_t count;
+};
+
+}  // namespace tactile
@@ -0,0 +1,134 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "TactileSkin.h"
+#include <algorithm>
+
+namespace tactile {
+
+const size_t TactileSkin::CHUNK_SIZE;
+
+TactileSkin::TactileSkin(size_t numThreads) : offsets(1, 0), pool(new ThreadPool(numThreads)) {}
+
+void TactileSkin::setNumThreads(size_t numThreads)
+{
+	pool.reset(new ThreadPool(numThreads));
+}
+
+size_t TactileSkin::add(size_t n, float min, float max)
+{
+	arrays.emplace_back(n, min, max);
+	offsets.push_back(offsets.back() + n);
+	// CHUNK_SIZE is a multiple of the cache line size: chunks start at aligned taxels
+	for (size_t start = 0; start < n; start += CHUNK_SIZE)
+		chunks.push_back(Chunk{ arrays.size() - 1, start, std::min(CHUNK_SIZE, n - start) });
+	return arrays.size() - 1;
+}
+
+template <typename Function>
+void TactileSkin::forEachChunk(Function fn) const
+{
+	const size_t numThreads = pool->size();
+	const size_t total = numTaxels();
+	if (numThreads == 1) {
+		for (const Chunk &chunk : chunks)
+			fn(chunk);
+		return;
+	}
+	// assign a contiguous sequence of chunks with about equal numbers of taxels to each thread
+	pool->run([&](size_t thread) {
+		const size_t first = total * thread / numThreads, last = total * (thread + 1) / numThreads;
+		for (const Chunk &chunk : chunks) {
+			const size_t begin = offsets[chunk.array] + chunk.start;
+			if (begin >= first && begin < last) fn(chunk);
+		}
+	});
+}
+
+template <typename Function>
+void TactileSkin::forEachArray(Function fn) const
+{
+	const size_t numThreads = std::min(pool->size(), arrays.size());
+	if (numThreads <= 1) {
+		for (size_t i = 0; i < arrays.size(); ++i)
+			fn(i);
+		return;
+	}
+	// arrays are assigned round-robin
+	pool->run([&](size_t thread) {
+		for (size_t i = thread; i < arrays.size(); i += numThreads)
+			fn(i);
+	});
+}
+
+template <typename Input>
+void TactileSkin::update(const Input *input)
+{
+	// update calibration runs upfront: they are rebuilt lazily, which is not thread-safe
+	for (auto &array : arrays)
+		array.calibrations().runs();
+	forEachChunk([this, input](const Chunk &chunk) {
+		TactileValueArray &array = arrays[chunk.array];
+		const Input *first = input + offsets[chunk.array];
+		if (!array.sparse())
+			array.updateValues(first + chunk.start, first + chunk.start + chunk.count, chunk.start);
+		else if (chunk.start == 0)  // sparse-mode buffers are shared by all taxels of an array
+			array.updateValues(first, first + array.size(), 0);
+	});
+}
+
+void TactileSkin::updateValues(const float *frame)
+{
+	update(frame);
+}
+
+void TactileSkin::updateValues(const uint16_t *codes)
+{
+	update(codes);
+}
+
+void TactileSkin::updateValues(const int16_t *codes)
+{
+	update(codes);
+}
+
+void TactileSkin::getValues(TactileValue::Mode mode, float *values) const
+{
+	forEachChunk([this, mode, values](const Chunk &chunk) {
+		float *first = values + offsets[chunk.array] + chunk.start;
+		arrays[chunk.array].getValues(mode, first, first + chunk.count, chunk.start);
+	});
+}
+
+void TactileSkin::accumulate(TactileValue::Mode mode, TactileValueArray::AccMode acc_mode,
+                             float *results, bool bMean) const
+{
+	forEachArray([&](size_t i) { results[i] = arrays[i].accumulate(mode, acc_mode, bMean); });
+}
+
+void TactileSkin::accumulateAll(TactileValue::Mode mode, TactileValueArray::Accumulation *results,
+                                bool bMean) const
+{
+	forEachArray([&](size_t i) { results[i] = arrays[i].accumulateAll(mode, bMean); });
+}
+
+}  // namespace tactile
@@ -0,0 +1,106 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include "TactileValueArray.h"
+#include "ThreadPool.h"
+#include <memory>
+#include <vector>
+
+namespace tactile {
+
+/* Skin composed of many TactileValueArrays, processed in parallel by a persistent thread pool.
+   Input and output frames concatenate the taxels of all arrays in the order of their addition.
+   Work is partitioned into chunks of taxels, which are aligned to cache lines within their array
+   and statically assigned to threads. Arrays in sparse mode (see TactileValueArray::setDeadband)
+   are updated as a whole by the thread owning their first chunk.
+   As each taxel's filter as well as each array's accumulation is computed by a single thread,
+   results do not depend on the thread count.
+ */
+class TactileSkin {
+public:
+	/// number of taxels processed as a unit of work
+	static const size_t CHUNK_SIZE = 1024;
+
+	/// create skin using given number of threads (0 = hardware concurrency)
+	explicit TactileSkin(size_t numThreads = 0);
+
+	/// number of threads used for processing
+	size_t numThreads() const { return pool->size(); }
+	void setNumThreads(size_t numThreads);
+
+	/// add array of n taxels, returning its index
+	/// References to previously added arrays are invalidated.
+	size_t add(size_t n, float min = FLT_MAX, float max = -FLT_MAX);
+	/// number of arrays
+	size_t size() const { return arrays.size(); }
+	/// total number of taxels of all arrays
+	size_t numTaxels() const { return offsets.back(); }
+	/// offset of array i within concatenated frames
+	size_t offset(size_t i) const { return offsets[i]; }
+
+	TactileValueArray &operator[](size_t i) { return arrays[i]; }
+	const TactileValueArray &operator[](size_t i) const { return arrays[i]; }
+
+	/// update all arrays from concatenated frame of numTaxels() values
+	void updateValues(const float *frame);
+	void updateValues(const uint16_t *codes);
+	void updateValues(const int16_t *codes);
+	template <class Iteratable>
+	void updateValues(const Iteratable &frame)
+	{
+		assert(frame.size() == numTaxels());
+		updateValues(frame.data());
+	}
+
+	/// fill concatenated values of given mode of all arrays into values[0, numTaxels())
+	void getValues(TactileValue::Mode mode, float *values) const;
+
+	/// accumulate values of given mode for each array into results[0, size())
+	void accumulate(TactileValue::Mode mode, TactileValueArray::AccMode acc_mode, float *results,
+	                bool bMean = true) const;
+	/// accumulate values of given mode with all reduction modes for each array
+	void accumulateAll(TactileValue::Mode mode, TactileValueArray::Accumulation *results,
+	                   bool bMean = true) const;
+
+private:
+	struct Chunk
+	{
+		size_t array, start, count;
+	};
+	/// process chunks in parallel, calling fn(chunk)
+	template <typename Function>
+	void forEachChunk(Function fn) const;
+	/// process arrays in parallel, calling fn(array)
+	template <typename Function>
+	void forEachArray(Function fn) const;
+	template <typename Input>
+	void update(const Input *input);
+
+	std::vector<TactileValueArray> arrays;
+	std::vector<size_t> offsets;  // offsets of arrays within frames, plus total size
+	std::vector<Chunk> chunks;    // chunks of all arrays
+	std::unique_ptr<ThreadPool> pool;
+};
+
+}  // namespace tactile
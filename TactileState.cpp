@@ -0,0 +1,55 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "TactileState.h"
+
+namespace tactile {
+
+void TactileState::bind(float *storage, size_t n)
+{
+	float **fields[NUM_FIELDS] = { &cur, &mean, &released, &absMin, &absMax, &dynMin, &dynMax };
+	const size_t s = stride(n);
+	for (size_t f = 0; f < NUM_FIELDS; ++f)
+		*fields[f] = storage + f * s;
+}
+
+float *TactileState::field(Field f) const
+{
+	float *const fields[NUM_FIELDS] = { cur, mean, released, absMin, absMax, dynMin, dynMax };
+	return fields[f];
+}
+
+TactileState TactileState::operator+(size_t offset) const
+{
+	TactileState result;
+	result.cur = cur + offset;
+	result.mean = mean + offset;
+	result.released = released + offset;
+	result.absMin = absMin + offset;
+	result.absMax = absMax + offset;
+	result.dynMin = dynMin + offset;
+	result.dynMax = dynMax + offset;
+	return result;
+}
+
+}  // namespace tactile
@@ -0,0 +1,85 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include <stddef.h>
+#include "AlignedAllocator.h"
+
+namespace tactile {
+
+/* Filter parameters (see TactileValue), shared by all taxels of an array unless overridden.
+   They are passed to the filter kernels alongside the state, keeping the latter free of
+   per-taxel parameter copies.
+ */
+struct TactileParams
+{
+	float meanLambda = 0.7f;
+	float rangeLambda = 0.9995f;
+	float releaseDecay = 0.05f;
+
+	bool operator==(const TactileParams &other) const
+	{
+		return meanLambda == other.meanLambda && rangeLambda == other.rangeLambda &&
+		       releaseDecay == other.releaseDecay;
+	}
+	bool operator!=(const TactileParams &other) const { return !(*this == other); }
+};
+
+/* Struct-of-arrays view onto the filter state of a range of taxels.
+   Each state variable of TactileValue is stored in its own contiguous float array,
+   which allows for tight, vectorizable loops over all taxels of an array.
+   The view doesn't own any memory, but is bound to an externally provided storage block.
+ */
+struct TactileState
+{
+	enum Field
+	{
+		CUR = 0,
+		MEAN,
+		RELEASED,
+		ABS_MIN,
+		ABS_MAX,
+		DYN_MIN,
+		DYN_MAX,
+		NUM_FIELDS
+	};
+
+	float *cur = nullptr, *mean = nullptr, *released = nullptr;
+	float *absMin = nullptr, *absMax = nullptr;
+	float *dynMin = nullptr, *dynMax = nullptr;
+
+	/// number of floats reserved per field for n taxels: rounded up to full cache lines
+	static size_t stride(size_t n) { return alignUp(n, CACHE_LINE_SIZE / sizeof(float)); }
+	/// number of floats required to store the state of n taxels
+	static size_t size(size_t n) { return NUM_FIELDS * stride(n); }
+
+	/// bind view to storage (of size(n) floats) holding the state of n taxels
+	void bind(float *storage, size_t n);
+	/// pointer to the values of given field
+	float *field(Field f) const;
+	/// view onto the state starting at given taxel index
+	TactileState operator+(size_t offset) const;
+};
+
+}  // namespace tactile
@@ -26,8 +26,17 @@
 
 namespace tactile {
 
+constexpr float TactileValue::DEFAULT_MEAN_TAU;
+constexpr float TactileValue::DEFAULT_RANGE_TAU;
+constexpr float TactileValue::DEFAULT_RELEASE_RATE;
+
 TactileValue::TactileValue(float fMin, float fMax)
-  : fMeanLambda(0.7), fRangeLambda(0.9995), fReleaseDecay(0.05)
+  : fMeanLambda(0.7)
+  , fRangeLambda(0.9995)
+  , fReleaseDecay(0.05)
+  , fMeanTau(DEFAULT_MEAN_TAU)
+  , fRangeTau(DEFAULT_RANGE_TAU)
+  , fReleaseRate(DEFAULT_RELEASE_RATE)
 {
 	init(fMin, fMax);
 }
@@ -108,12 +117,58 @@ void TactileValue::update(float fNew)
 	fCur = fNew;
 }
 
+void TactileValue::update(float fNew, unsigned int nFrames)
+{
+	if (nFrames == 0 || !isfinite(fNew)) return;
+	// the first step might change the release state, afterwards fCur equals (calibrated) fNew
+	update(fNew);
+	if (nFrames > 1 && !isnan(fCur))
+		decay(fCur, nFrames - 1, fMeanLambda, fRangeLambda, fReleaseDecay, fMean, rDynRange.min(),
+		      rDynRange.max(), fReleased);
+}
+
+void TactileValue::updateElapsed(float fNew, float dt)
+{
+	fMeanLambda = expf(-dt / fMeanTau);
+	fRangeLambda = expf(-dt / fRangeTau);
+	fReleaseDecay = fReleaseRate * dt;
+	update(fNew);
+}
+
+void TactileValue::decay(float fCur, unsigned int nFrames, float fMeanLambda, float fRangeLambda,
+                         float fReleaseDecay, float& fMean, float& fMin, float& fMax,
+                         float& fReleased)
+{
+	// as fMin <= fCur <= fMax, each step scales the distances to fCur by the lambdas
+	const float fRangeScale = powf(fRangeLambda, nFrames);
+	const float fRange = fMax - fMin;
+	fMin = fCur - fRangeScale * (fCur - fMin);
+	fMax = fCur + fRangeScale * (fMax - fCur);
+	fMean = fCur + powf(fMeanLambda, nFrames) * (fMean - fCur);
+
+	if (fReleased == FLT_MAX) return;  // no release mode can be entered without change
+	// release value decays by fReleaseDecay times the (geometrically shrinking) ranges of all
+	// steps, i.e. by sum_{j=1..k} lambda^j * range. As fReleased decreases and fMin increases
+	// monotonically, release mode is left after k steps if it was left at any step.
+	const float fSteps = fRangeLambda == 1.f
+	                         ? nFrames
+	                         : fRangeLambda * (1.f - fRangeScale) / (1.f - fRangeLambda);
+	fReleased -= fReleaseDecay * fRange * fSteps;
+	if (fReleased < fMin) fReleased = FLT_MAX;
+}
+
 float TactileValue::value(Mode mode) const
+{
+	return value(mode, fCur, fMean, fReleased, rAbsRange, rDynRange);
+}
+
+float TactileValue::value(Mode mode, float fCur, float fMean, float fReleased,
+                          const Range& absRange, const Range& dynRange)
 {
 	if (mode == rawCurrent) return fCur;
 	if (mode == rawMean) return fMean;
 
-	const Range& r = (mode == absCurrent || mode == absMean) ? rAbsRange : rDynRange;
+	const Range& r = (mode == absCurrent || mode == absMean) ? absRange : dynRange;
 	float fRange = r.range();
 	if (fRange < FLT_EPSILON) return NAN;  // do not divide by zero
 
@@ -129,6 +184,12 @@ void TactileValue::setMeanLambda(float fLambda)
 {
 	this->fMeanLambda = fLambda;
 }
+void TactileValue::setTimeConstants(float fMeanTau, float fRangeTau, float fReleaseRate)
+{
+	this->fMeanTau = fMeanTau;
+	this->fRangeTau = fRangeTau;
+	this->fReleaseRate = fReleaseRate;
+}
 void TactileValue::setRangeLambda(float fLambda)
 {
 	this->fRangeLambda = fLambda;
@@ -49,6 +49,11 @@ public:
 		dynMeanRelease,     // averaged dynMeanRelease
 		lastMode = dynMeanRelease,
 	};
+	/// default time constants, equivalent to the default lambdas at a frame rate of 1 kHz
+	static constexpr float DEFAULT_MEAN_TAU = 0.0028037f;  // -1 ms / ln(0.7)
+	static constexpr float DEFAULT_RANGE_TAU = 1.9995f;    // -1 ms / ln(0.9995)
+	static constexpr float DEFAULT_RELEASE_RATE = 50.f;    // 0.05 / 1 ms
+
 	TactileValue(float fMin = FLT_MAX, float fMax = -FLT_MAX);
 
 	static Mode getMode(const std::string& sName);
@@ -56,16 +61,34 @@ public:
 
 	void init(float fMin = FLT_MAX, float fMax = -FLT_MAX);
 	void update(float fNew);
+	/// equivalent of nFrames calls of update(fNew), computing the decay in closed form,
+	/// e.g. to catch up with frames skipped for an idle taxel or dropped by decimation
+	void update(float fNew, unsigned int nFrames);
+	/// update with a value acquired dt seconds after the previous one, deriving the lambdas from
+	/// the time constants: lambda = exp(-dt / tau), releaseDecay = releaseRate * dt
+	void updateElapsed(float fNew, float dt);
+	/// apply nFrames filter steps with constant input fCur (equal to the current value) in closed
+	/// form to mean, dynamic range, and release state
+	static void decay(float fCur, unsigned int nFrames, float fMeanLambda, float fRangeLambda,
+	                  float fReleaseDecay, float& fMean, float& fMin, float& fMax, float& fReleased);
 
 	float value(Mode mode) const;
+	/// compute value of given mode from explicitly passed filter state
+	static float value(Mode mode, float fCur, float fMean, float fReleased, const Range& absRange,
+	                   const Range& dynRange);
 
 	void setMeanLambda(float fLambda);
 	void setRangeLambda(float fLambda);
 	void setReleaseDecay(float fDecay);
+	/// time constants (in seconds) and release rate (per second) used by updateElapsed()
+	void setTimeConstants(float fMeanTau, float fRangeTau, float fReleaseRate);
 
 	float getMeanLambda() const { return fMeanLambda; }
 	float getRangeLambda() const { return fRangeLambda; }
 	float getReleaseDecay() const { return fReleaseDecay; }
+	float getMeanTau() const { return fMeanTau; }
+	float getRangeTau() const { return fRangeTau; }
+	float getReleaseRate() const { return fReleaseRate; }
 
 	const Range& absRange() const { return rAbsRange; }
 	const Range& dynRange() const { return rDynRange; }
@@ -74,7 +97,10 @@ public:
 	std::shared_ptr<Calibration> getCalibration() const { return calib; }
 
 protected:
+	friend class TactileValueArray;
+
 	float fMeanLambda, fRangeLambda, fReleaseDecay;
+	float fMeanTau, fRangeTau, fReleaseRate;
 	float fCur, fMean, fReleased;
 	Range rAbsRange;
 	Range rDynRange;
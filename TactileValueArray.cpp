@@ -22,7 +22,13 @@
  *
  * ============================================================ */
 #include "TactileValueArray.h"
-#include <numeric>
+#include "UpdateKernel.h"
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdexcept>
 
 namespace tactile {
 
@@ -31,18 +37,448 @@ TactileValueArray::TactileValueArray(size_t n, float min, float max)
 	init(n, min, max);
 }
 
+TactileValueArray::TactileValueArray(float *storage, size_t capacity, size_t n, float min,
+                                     float max)
+{
+	assert(reinterpret_cast<uintptr_t>(storage) % CACHE_LINE_SIZE == 0);
+	bExternal = true;
+	bind(storage, capacity);
+	calib.reserve(capacity);
+	taxelRegions.reserve(capacity);
+	init(n, min, max);
+}
+
+TactileValueArray::TactileValueArray(const TactileValueArray &other)
+{
+	*this = other;
+}
+
+TactileValueArray &TactileValueArray::operator=(const TactileValueArray &other)
+{
+	if (this == &other) return *this;
+	// copies always own their storage
+	n = other.n;
+	bExternal = false;
+	vStorage.assign(other.pStorage,
+	                other.pStorage ? other.pStorage + storageSize(other.nCapacity) : nullptr);
+	bind(vStorage.data(), other.nCapacity);
+	calib = other.calib;
+	taxelRegions = other.taxelRegions;
+	bSparse = other.bSparse;
+	vDeadband = other.vDeadband;
+	vActiveBits = other.vActiveBits;
+	vActive = other.vActive;
+	bLazyDecay = other.bLazyDecay;
+	vPending = other.vPending;
+	if (bSparse) reserveSparse();
+	params = other.params;
+	rates = other.rates;
+	vOverrides = other.vOverrides;
+	dLastTimestamp = other.dLastTimestamp;
+	return *this;
+}
+
+TactileValueArray::TactileValueArray(TactileValueArray &&other)
+{
+	*this = std::move(other);
+}
+
+TactileValueArray &TactileValueArray::operator=(TactileValueArray &&other)
+{
+	if (this == &other) return *this;
+	n = other.n;
+	bExternal = other.bExternal;
+	vStorage = std::move(other.vStorage);
+	bind(bExternal ? other.pStorage : vStorage.data(), other.nCapacity);
+	calib = std::move(other.calib);
+	taxelRegions = std::move(other.taxelRegions);
+	bSparse = other.bSparse;
+	vDeadband = std::move(other.vDeadband);
+	vActiveBits = std::move(other.vActiveBits);
+	vActive = std::move(other.vActive);
+	vUpdate = std::move(other.vUpdate);
+	vFlags = std::move(other.vFlags);
+	bLazyDecay = other.bLazyDecay;
+	vPending = std::move(other.vPending);
+	params = other.params;
+	rates = other.rates;
+	vOverrides = std::move(other.vOverrides);
+	dLastTimestamp = other.dLastTimestamp;
+	vBatch = std::move(other.vBatch);
+
+	// reset other to an empty array without storage
+	other.n = 0;
+	other.bExternal = false;
+	other.vStorage.clear();
+	other.bind(nullptr, 0);
+	other.calib = CalibrationBank();
+	other.taxelRegions = TaxelRegions();
+	other.bSparse = false;
+	other.vDeadband.clear();
+	other.vActiveBits.clear();
+	other.vActive.clear();
+	other.vUpdate.clear();
+	other.vFlags.clear();
+	other.bLazyDecay = false;
+	other.vPending.clear();
+	other.params = TactileParams();
+	other.rates = TimeRates();
+	other.vOverrides.clear();
+	other.dLastTimestamp = NAN;
+	other.vBatch.clear();
+	return *this;
+}
+
+void TactileValueArray::bind(float *storage, size_t capacity)
+{
+	pStorage = storage;
+	nCapacity = capacity;
+	state.bind(storage, capacity);
+	pFrame = storage ? storage + TactileState::size(capacity) : nullptr;
+}
+
+void TactileValueArray::reserve(size_t capacity)
+{
+	if (capacity <= nCapacity) return;
+	if (bExternal) throw std::length_error("capacity of external storage exceeded");
+
+	// allocate new storage, keeping the state of existing taxels
+	std::vector<float, AlignedAllocator<float>> storage(storageSize(capacity));
+	const size_t oldStride = TactileState::stride(nCapacity);
+	const size_t newStride = TactileState::stride(capacity);
+	for (size_t f = 0; f < TactileState::NUM_FIELDS; ++f)
+		std::copy_n(pStorage + f * oldStride, n, storage.data() + f * newStride);
+	vStorage.swap(storage);
+	bind(vStorage.data(), capacity);
+	calib.reserve(capacity);
+	taxelRegions.reserve(capacity);
+	if (bSparse) reserveSparse();
+}
+
 void TactileValueArray::init(size_t n, float min, float max)
 {
-	vSensors.resize(n);
+	reserve(n);
+	// keep the parameters of already existing taxels, new ones use the shared parameters
+	const size_t keep = std::min(n, this->n);
+	vOverrides.erase(findOverride(keep), vOverrides.end());
+
+	if (bSparse) std::fill(vDeadband.begin() + keep, vDeadband.begin() + n, 0.f);
+
+	this->n = n;
+	calib.resize(n);
+	taxelRegions.resize(n);
 	reset(min, max);
 }
 
+size_t TactileValueArray::storageSize(const std::vector<size_t> &capacities)
+{
+	size_t size = 0;
+	for (size_t capacity : capacities)
+		size += storageSize(capacity);
+	return size;
+}
+
+std::vector<TactileValueArray> TactileValueArray::createArrays(
+    float *storage, const std::vector<size_t> &capacities)
+{
+	std::vector<TactileValueArray> arrays;
+	arrays.reserve(capacities.size());
+	for (size_t capacity : capacities) {
+		// storage sizes are multiples of full cache lines, keeping all arrays aligned
+		arrays.emplace_back(storage, capacity, capacity);
+		storage += storageSize(capacity);
+	}
+	return arrays;
+}
+
 void TactileValueArray::reset(float min, float max)
 {
-	for (auto &sensor : vSensors)
-		sensor.init(min, max);
+	clearActive();
+	std::fill(vPending.begin(), vPending.end(), 0);
+	dLastTimestamp = NAN;
+	std::fill_n(state.cur, n, NAN);
+	std::fill_n(state.mean, n, NAN);
+	std::fill_n(state.released, n, FLT_MAX);
+	std::fill_n(state.absMin, n, min);
+	std::fill_n(state.absMax, n, max);
+	std::fill_n(state.dynMin, n, FLT_MAX);
+	std::fill_n(state.dynMax, n, -FLT_MAX);
+}
+
+void TactileValueArray::updateFrame(size_t start, size_t count)
+{
+	float *frame = pFrame + start;
+	// calibrate runs of taxels sharing the same calibration with a single batch call
+	calib.forEachRun(start, count, [frame](size_t begin, size_t end, const Calibration *c) {
+		c->map(frame + begin, frame + begin, end - begin);
+	});
+	filter(start, count);
+}
+
+void TactileValueArray::updateFrames(const float *data, size_t nFrames, size_t stride)
+{
+	if (empty()) init(stride);
+	assert(stride >= n);
+	if (n == 0) return;
+
+	bool calibrated = false;
+	calib.forEachRun(0, n, [&calibrated](size_t, size_t, const Calibration *) { calibrated = true; });
+	if (!calibrated) {  // filter input frames in place
+		filterFrames(data, nFrames, stride);
+		return;
+	}
+
+	// calibrate batches of frames into an aligned buffer, then filter them
+	const size_t batchStride = TactileState::stride(n);
+	if (vBatch.size() < FRAME_BATCH * batchStride) vBatch.resize(FRAME_BATCH * batchStride);
+	for (size_t done = 0; done < nFrames; done += FRAME_BATCH) {
+		const size_t frames = std::min(size_t(FRAME_BATCH), nFrames - done);
+		for (size_t f = 0; f < frames; ++f) {
+			const float *in = data + (done + f) * stride;
+			float *out = vBatch.data() + f * batchStride;
+			std::copy_n(in, n, out);
+			calib.forEachRun(0, n, [in, out](size_t begin, size_t end, const Calibration *c) {
+				c->map(in + begin, out + begin, end - begin);
+			});
+		}
+		filterFrames(vBatch.data(), frames, batchStride);
+	}
+}
+
+void TactileValueArray::filterFrames(const float *data, size_t nFrames, size_t stride)
+{
+	forEachParamRun(0, n, [&](size_t begin, size_t end, const TactileParams &p) {
+		UpdateKernel::updateFrames(state + begin, p, data + begin, end - begin, nFrames, stride);
+	});
+}
+
+void TactileValueArray::filter(size_t start, size_t count)
+{
+	if (!bSparse) {
+		filterDense(start, count);
+		return;
+	}
+
+	// select taxels exceeding their deadband, masking others with NaN (ignored by the filter)
+	// This (vectorizable) pass flags updated taxels, which are collected by skipping zero words.
+	float *frame = pFrame + start;
+	const float *cur = state.cur + start;
+	const float *deadband = vDeadband.data() + start;
+	uint8_t *flags = vFlags.data();
+	for (size_t i = 0; i < count; ++i) {
+		const float x = frame[i];
+		// NaN fails all comparisons, inf fails the first one (bitwise & avoids branches)
+		const bool valid = fabsf(x) <= FLT_MAX;
+		const bool update = valid & !(fabsf(x - cur[i]) < deadband[i]);
+		flags[i] = update | valid << 1;  // bit 0: update, bit 1: valid input
+		frame[i] = update ? x : NAN;
+	}
+	if (bLazyDecay) {
+		uint32_t *pending = vPending.data() + start;
+		for (size_t i = 0; i < count; ++i)
+			pending[i] += flags[i] == 2;  // valid input within deadband
+	}
+	vUpdate.clear();
+	for (size_t word = 0; word < count; word += sizeof(uint64_t)) {
+		uint64_t bytes = 0;
+		memcpy(&bytes, flags + word, std::min(sizeof(uint64_t), count - word));
+		if (!(bytes & 0x0101010101010101ull)) continue;
+		for (size_t i = word, end = std::min(word + sizeof(uint64_t), count); i < end; ++i) {
+			if (!(flags[i] & 1)) continue;
+			const size_t taxel = start + i;
+			if (vPending[taxel]) {  // catch up with skipped frames before applying new value
+				UpdateKernel::updateRepeated(state, parameters(taxel), taxel, state.cur[taxel],
+				                             vPending[taxel]);
+				vPending[taxel] = 0;
+			}
+			vUpdate.push_back(taxel);
+			uint64_t &bits = vActiveBits[taxel / 64];
+			const uint64_t mask = uint64_t(1) << (taxel % 64);
+			if (!(bits & mask)) {
+				bits |= mask;
+				vActive.push_back(taxel);
+			}
+		}
+	}
+	// few scattered taxels are filtered individually, many ones with the vectorized kernel
+	if (vUpdate.size() * 8 >= count)
+		filterDense(start, count);
+	else if (vOverrides.empty())
+		UpdateKernel::updateIndexed(state, params, pFrame, vUpdate.data(), vUpdate.size());
+	else {
+		for (const uint32_t &taxel : vUpdate)
+			UpdateKernel::updateIndexed(state, parameters(taxel), pFrame, &taxel, 1);
+	}
+}
+
+void TactileValueArray::filterDense(size_t start, size_t count)
+{
+	const float *frame = pFrame + start;
+	forEachParamRun(start, count, [&](size_t begin, size_t end, const TactileParams &p) {
+		UpdateKernel::update(state + (start + begin), p, frame + begin, end - begin);
+	});
+}
+
+void TactileValueArray::reserveSparse()
+{
+	// sized for the capacity, such that updates never allocate
+	vDeadband.resize(nCapacity, 0.f);
+	vActiveBits.resize((nCapacity + 63) / 64, 0);
+	vActive.reserve(nCapacity);
+	vUpdate.reserve(nCapacity);
+	vFlags.resize(nCapacity);
+	vPending.resize(nCapacity, 0);
+}
+
+void TactileValueArray::setDeadband(float fDeadband)
+{
+	if (fDeadband > 0 && !bSparse) {
+		bSparse = true;
+		reserveSparse();
+	}
+	if (bSparse) std::fill_n(vDeadband.begin(), n, fDeadband);
+}
+
+void TactileValueArray::setDeadband(size_t i, float fDeadband)
+{
+	assert(i < n);
+	if (fDeadband > 0 && !bSparse) {
+		bSparse = true;
+		reserveSparse();
+	}
+	if (bSparse) vDeadband[i] = fDeadband;
+}
+
+void TactileValueArray::catchUp()
+{
+	if (!bSparse) return;
+	forEachParamRun(0, n, [this](size_t begin, size_t end, const TactileParams &p) {
+		for (size_t i = begin; i < end; ++i) {
+			if (!vPending[i]) continue;
+			UpdateKernel::updateRepeated(state, p, i, state.cur[i], vPending[i]);
+			vPending[i] = 0;
+		}
+	});
+}
+
+void TactileValueArray::repeat(unsigned int nFrames)
+{
+	catchUp();
+	forEachParamRun(0, n, [this, nFrames](size_t begin, size_t end, const TactileParams &p) {
+		for (size_t i = begin; i < end; ++i)
+			UpdateKernel::updateRepeated(state, p, i, state.cur[i], nFrames);
+	});
+}
+
+void TactileValueArray::setTimeConstants(float fMeanTau, float fRangeTau, float fReleaseRate)
+{
+	assert(fMeanTau > 0.f && fRangeTau > 0.f);
+	rates.mean = 1.f / fMeanTau;
+	rates.range = 1.f / fRangeTau;
+	rates.release = fReleaseRate;
+	for (Override &o : vOverrides) {
+		o.rates = rates;
+		o.bTimed = true;
+	}
+}
+
+void TactileValueArray::setTimeConstants(size_t i, float fMeanTau, float fRangeTau,
+                                         float fReleaseRate)
+{
+	assert(fMeanTau > 0.f && fRangeTau > 0.f);
+	Override &o = override(i);
+	o.rates.mean = 1.f / fMeanTau;
+	o.rates.range = 1.f / fRangeTau;
+	o.rates.release = fReleaseRate;
+	o.bTimed = true;
+}
+
+void TactileValueArray::applyElapsed(double timestamp)
+{
+	// first frame (or after reset()) and out-of-order timestamps don't decay
+	const float dt = timestamp > dLastTimestamp ? float(timestamp - dLastTimestamp) : 0.f;
+	dLastTimestamp = timestamp;
+
+	// lambdas are computed once per frame: for the shared parameters and each timed override
+	// Frames pending from lazy decay are applied with the lambdas they arrived with,
+	// i.e. before changing any lambdas.
+	bool bFlushed = !(bSparse && bLazyDecay);
+	auto apply = [this, dt, &bFlushed](const TimeRates &r, TactileParams &target) {
+		TactileParams p;
+		p.meanLambda = expf(-dt * r.mean);
+		p.rangeLambda = expf(-dt * r.range);
+		p.releaseDecay = dt * r.release;
+		if (p == target) return;
+		if (!bFlushed) {
+			catchUp();
+			bFlushed = true;
+		}
+		target = p;
+	};
+	apply(rates, params);
+	for (Override &o : vOverrides)
+		if (o.bTimed) apply(o.rates, o.params);
+}
+
+void TactileValueArray::clearActive()
+{
+	for (uint32_t i : vActive)
+		vActiveBits[i / 64] = 0;
+	vActive.clear();
+}
+
+template <typename Code>
+static void calibrateCodes(CalibrationBank &calib, const Code *codes, float *frame, size_t start,
+                           size_t count)
+{
+	// only uncalibrated taxels (between calibrated runs) are converted to float
+	size_t done = 0;
+	calib.forEachRun(start, count,
+	                 [codes, frame, &done](size_t begin, size_t end, const Calibration *c) {
+		                 std::copy(codes + done, codes + begin, frame + done);
+		                 c->map(codes + begin, frame + begin, end - begin);
+		                 done = end;
+	                 });
+	std::copy(codes + done, codes + count, frame + done);
+}
+
+void TactileValueArray::updateCodes(const uint16_t *codes, size_t start, size_t count)
+{
+	float *frame = pFrame + start;
+	calibrateCodes(calib, codes, frame, start, count);
+	filter(start, count);
+}
+
+void TactileValueArray::updateCodes(const int16_t *codes, size_t start, size_t count)
+{
+	float *frame = pFrame + start;
+	calibrateCodes(calib, codes, frame, start, count);
+	filter(start, count);
+}
+
+void TactileValueArray::loadCalibrations(const std::string &sYAMLFile)
+{
+	CalibrationBank bank(n);
+	bank.load(sYAMLFile);
+	if (empty())
+		init(bank.size());
+	else if (bank.size() > n)
+		throw std::out_of_range("calibration file refers to taxels beyond array size");
+	calib = bank;
+	calib.resize(n);
 }
 
+void TactileValueArray::loadRegions(const std::string &sYAMLFile)
+{
+	TaxelRegions regions(n);
+	regions.load(sYAMLFile);
+	if (empty())
+		init(regions.size());
+	else if (regions.size() > n)
+		throw std::out_of_range("region file refers to taxels beyond array size");
+	taxelRegions = regions;
+	taxelRegions.resize(n);
+}
 
 TactileValueArray::AccMode TactileValueArray::getMode(const std::string &sName)
 {
@@ -53,6 +489,7 @@ TactileValueArray::AccMode TactileValueArray::getMode(const std::string &sName)
 	if (sName == "CountNegative") return CountNegative;
 	if (sName == "Min") return Min;
 	if (sName == "Max") return Max;
+	if (sName == "Median") return Median;
 	return SumPositive;  // default fallback
 }
 
@@ -66,115 +503,471 @@ std::string TactileValueArray::getModeName(AccMode m)
 		case CountNegative: return "CountNegative";
 		case Min: return "Min";
 		case Max: return "Max";
+		case Median: return "Median";
 		default: return "";
 	}
 }
 
 TactileValueArray::vector_data TactileValueArray::getValues(TactileValue::Mode mode) const
 {
-	vector_data vReturn(vSensors.size());
+	vector_data vReturn(n);
 	getValues(mode, vReturn);
 	return vReturn;
 }
 
-typedef float (*AccumulatorFunction)(const float, const float);
-static float Add(float result, float c)
+// number of taxels processed at once by multi-mode getValues()
+static const size_t BLOCK_SIZE = 256;
+
+template <TactileValue::Mode mode>
+static void fillBlock(const TactileState &s, const float *min, const float *scale, float *out,
+                      size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		out[i] = TactileValueArray::unscaledValue<mode>(s, i, min[i]) * scale[i];
+}
+
+void TactileValueArray::getValues(const std::vector<ModeOutput> &outputs, size_t count,
+                                  ptrdiff_t offset) const
+{
+	// start from begin() (when offset >= 0) or from end() (otherwise)
+	const ptrdiff_t start = offset >= 0 ? offset : ptrdiff_t(n) + offset;
+	assert(start >= 0 && start + ptrdiff_t(count) <= ptrdiff_t(n));
+
+	// reciprocals of abs and dyn ranges, shared by all outputs
+	float absScale[BLOCK_SIZE], dynScale[BLOCK_SIZE];
+	for (size_t block = 0; block < count; block += BLOCK_SIZE) {
+		const TactileState s = state + (start + block);
+		const size_t size = std::min(BLOCK_SIZE, count - block);
+		for (size_t i = 0; i < size; ++i) {
+			const float fAbs = s.absMax[i] - s.absMin[i];
+			const float fDyn = s.dynMax[i] - s.dynMin[i];
+			absScale[i] = 1.f / (fAbs < FLT_EPSILON ? NAN : fAbs);
+			dynScale[i] = 1.f / (fDyn < FLT_EPSILON ? NAN : fDyn);
+		}
+		for (const ModeOutput &output : outputs) {
+			float *out = output.values + block;
+			switch (output.mode) {
+				case TactileValue::rawCurrent: std::copy_n(s.cur, size, out); break;
+				case TactileValue::rawMean: std::copy_n(s.mean, size, out); break;
+				case TactileValue::absCurrent:
+					fillBlock<TactileValue::absCurrent>(s, s.absMin, absScale, out, size);
+					break;
+				case TactileValue::absMean:
+					fillBlock<TactileValue::absMean>(s, s.absMin, absScale, out, size);
+					break;
+				case TactileValue::dynCurrent:
+					fillBlock<TactileValue::dynCurrent>(s, s.dynMin, dynScale, out, size);
+					break;
+				case TactileValue::dynMean:
+					fillBlock<TactileValue::dynMean>(s, s.dynMin, dynScale, out, size);
+					break;
+				case TactileValue::dynCurrentRelease:
+					fillBlock<TactileValue::dynCurrentRelease>(s, s.dynMin, dynScale, out, size);
+					break;
+				case TactileValue::dynMeanRelease:
+					fillBlock<TactileValue::dynMeanRelease>(s, s.dynMin, dynScale, out, size);
+					break;
+			}
+		}
+	}
+}
+
+float TactileValueArray::ConstReference::value(TactileValue::Mode mode) const
+{
+	const TactileState &s = array->state;
+	return TactileValue::value(mode, s.cur[index], s.mean[index], s.released[index], absRange(),
+	                           dynRange());
+}
+
+Range TactileValueArray::ConstReference::absRange() const
 {
-	return result + c;
+	return Range(array->state.absMin[index], array->state.absMax[index]);
 }
-static float posAdd(float result, float c)
+
+Range TactileValueArray::ConstReference::dynRange() const
 {
-	if (c > 0)
-		return result + c;
-	else
-		return result;
+	return Range(array->state.dynMin[index], array->state.dynMax[index]);
 }
-static float negAdd(float result, float c)
+
+std::shared_ptr<Calibration> TactileValueArray::ConstReference::getCalibration() const
 {
-	if (c < 0)
-		return result + c;
-	else
-		return result;
+	return array->calib.get(index);
 }
-static float posCnt(float result, float c)
+
+TactileValueArray::ConstReference::operator TactileValue() const
 {
-	if (c > 0)
-		return result + 1;
-	else
-		return result;
+	const TactileState &s = array->state;
+	TactileValue result;
+	result.setMeanLambda(getMeanLambda());
+	result.setRangeLambda(getRangeLambda());
+	result.setReleaseDecay(getReleaseDecay());
+	result.setCalibration(getCalibration());
+	result.fCur = s.cur[index];
+	result.fMean = s.mean[index];
+	result.fReleased = s.released[index];
+	result.rAbsRange = absRange();
+	result.rDynRange = dynRange();
+	return result;
 }
-static float negCnt(float result, float c)
+
+void TactileValueArray::Reference::init(float fMin, float fMax) const
 {
-	if (c < 0)
-		return result + 1;
-	else
-		return result;
+	const TactileState &s = array->state;
+	s.cur[index] = s.mean[index] = NAN;
+	s.released[index] = FLT_MAX;
+	s.absMin[index] = fMin;
+	s.absMax[index] = fMax;
+	s.dynMin[index] = FLT_MAX;
+	s.dynMax[index] = -FLT_MAX;
 }
-static float minFun(float result, float c)
+
+void TactileValueArray::Reference::update(float fNew) const
 {
-	return std::min(result, c);
+	if (!isfinite(fNew)) return;  // do not use invalid value
+	if (auto calib = getCalibration()) fNew = calib->map(fNew);
+	UpdateKernel::update(array->state + index, array->parameters(index), &fNew, 1);
 }
-static float maxFun(float result, float c)
+
+void TactileValueArray::Reference::setMeanLambda(float fLambda) const
+{
+	self().fixedParameters(index).meanLambda = fLambda;
+}
+void TactileValueArray::Reference::setRangeLambda(float fLambda) const
 {
-	return std::max(result, c);
+	self().fixedParameters(index).rangeLambda = fLambda;
+}
+void TactileValueArray::Reference::setReleaseDecay(float fDecay) const
+{
+	self().fixedParameters(index).releaseDecay = fDecay;
 }
 
-static float INITIAL[] = { 0, 0, 0, 0, 0, FLT_MAX, -FLT_MAX };
-static AccumulatorFunction ACCUMULATORS[] = { Add, posAdd, negAdd, posCnt, negCnt, minFun, maxFun };
+void TactileValueArray::Reference::setCalibration(const std::shared_ptr<Calibration> &c) const
+{
+	self().calib.set(index, c);
+}
+
+// per-thread scratch buffer for order statistics, growing to the largest size requested
+static float *scratch(size_t n)
+{
+	static thread_local std::vector<float> buffer;
+	if (buffer.size() < n) buffer.resize(n);
+	return buffer.data();
+}
+
+// q-quantile of values [first, last), linearly interpolating between order statistics
+// Values are reordered and NaNs removed, selection runs in linear (average) time.
+static float selectQuantile(float *first, float *last, float q)
+{
+	assert(q >= 0 && q <= 1);
+	last = std::remove_if(first, last, [](float v) { return isnan(v); });
+	const size_t n = last - first;
+	if (n == 0) return NAN;
+
+	const float h = q * (n - 1);
+	const size_t k = std::min(size_t(h), n - 1);
+	std::nth_element(first, first + k, last);
+	const float lo = first[k];
+	if (k + 1 == n) return lo;
+	// next order statistic: minimum of the upper partition
+	const float hi = *std::min_element(first + k + 1, last);
+	return lo + (h - k) * (hi - lo);
+}
+
+float TactileValueArray::quantile(const vector_data &data, float q)
+{
+	float *values = scratch(data.size());
+	std::copy(data.begin(), data.end(), values);
+	return selectQuantile(values, values + data.size(), q);
+}
+
+float TactileValueArray::quantile(TactileValue::Mode mode, float q) const
+{
+	float *values = scratch(n);
+	getValues(mode, values, values + n);
+	return selectQuantile(values, values + n, q);
+}
+
+// count values [first, last) into bins of equal width covering [lo, hi)
+static void countBins(const float *first, const float *last, float lo, float hi,
+                      std::vector<size_t> &bins)
+{
+	if (bins.empty()) return;
+	const float fMaxBin = bins.size() - 1;
+	const float fScale = bins.size() / (hi - lo);
+	for (; first != last; ++first) {
+		if (isnan(*first)) continue;
+		float bin = (*first - lo) * fScale;
+		bin = bin > 0 ? bin : 0;
+		bin = bin < fMaxBin ? bin : fMaxBin;
+		++bins[size_t(bin)];
+	}
+}
+
+void TactileValueArray::histogram(const vector_data &data, float lo, float hi,
+                                  std::vector<size_t> &bins)
+{
+	assert(lo < hi);
+	std::fill(bins.begin(), bins.end(), 0);
+	countBins(data.data(), data.data() + data.size(), lo, hi, bins);
+}
+
+void TactileValueArray::histogram(TactileValue::Mode mode, float lo, float hi,
+                                  std::vector<size_t> &bins) const
+{
+	assert(lo < hi);
+	std::fill(bins.begin(), bins.end(), 0);
+	// compute values blockwise into a stack buffer
+	float values[BLOCK_SIZE];
+	for (size_t start = 0; start < n; start += BLOCK_SIZE) {
+		const size_t count = std::min(BLOCK_SIZE, n - start);
+		getValues(mode, values, values + count, start);
+		countBins(values, values + count, lo, hi, bins);
+	}
+}
+
+// dispatch runtime acc mode to compile-time instance Fn::call<acc>(args...)
+template <class Fn, typename... Args>
+static float dispatch(TactileValueArray::AccMode mode, const Args &... args)
+{
+	switch (mode) {
+		case TactileValueArray::Sum: return Fn::template call<TactileValueArray::Sum>(args...);
+		case TactileValueArray::SumPositive:
+			return Fn::template call<TactileValueArray::SumPositive>(args...);
+		case TactileValueArray::SumNegative:
+			return Fn::template call<TactileValueArray::SumNegative>(args...);
+		case TactileValueArray::CountPositive:
+			return Fn::template call<TactileValueArray::CountPositive>(args...);
+		case TactileValueArray::CountNegative:
+			return Fn::template call<TactileValueArray::CountNegative>(args...);
+		case TactileValueArray::Min: return Fn::template call<TactileValueArray::Min>(args...);
+		case TactileValueArray::Max: return Fn::template call<TactileValueArray::Max>(args...);
+		case TactileValueArray::Median:  // not a reduction
+		case TactileValueArray::lastMode: break;
+	}
+	throw std::invalid_argument("invalid accumulation mode");
+}
+
+namespace {
+struct AccumulateData
+{
+	template <TactileValueArray::AccMode acc>
+	static float call(const TactileValueArray::vector_data &data, bool bMean)
+	{
+		return TactileValueArray::accumulate<acc>(data, bMean);
+	}
+};
+
+struct AccumulateMode
+{
+	template <TactileValueArray::AccMode acc>
+	static float call(const TactileValueArray &array, TactileValue::Mode mode, bool bMean)
+	{
+		switch (mode) {
+			case TactileValue::rawCurrent:
+				return array.accumulate<TactileValue::rawCurrent, acc>(bMean);
+			case TactileValue::rawMean: return array.accumulate<TactileValue::rawMean, acc>(bMean);
+			case TactileValue::absCurrent:
+				return array.accumulate<TactileValue::absCurrent, acc>(bMean);
+			case TactileValue::absMean: return array.accumulate<TactileValue::absMean, acc>(bMean);
+			case TactileValue::dynCurrent:
+				return array.accumulate<TactileValue::dynCurrent, acc>(bMean);
+			case TactileValue::dynMean: return array.accumulate<TactileValue::dynMean, acc>(bMean);
+			case TactileValue::dynCurrentRelease:
+				return array.accumulate<TactileValue::dynCurrentRelease, acc>(bMean);
+			case TactileValue::dynMeanRelease:
+				return array.accumulate<TactileValue::dynMeanRelease, acc>(bMean);
+		}
+		throw std::invalid_argument("invalid mode");
+	}
+};
+
+struct AccumulateActive
+{
+	template <TactileValueArray::AccMode acc>
+	static float call(const TactileValueArray &array, TactileValue::Mode mode, bool bMean)
+	{
+		switch (mode) {
+			case TactileValue::rawCurrent:
+				return array.accumulateActive<TactileValue::rawCurrent, acc>(bMean);
+			case TactileValue::rawMean:
+				return array.accumulateActive<TactileValue::rawMean, acc>(bMean);
+			case TactileValue::absCurrent:
+				return array.accumulateActive<TactileValue::absCurrent, acc>(bMean);
+			case TactileValue::absMean:
+				return array.accumulateActive<TactileValue::absMean, acc>(bMean);
+			case TactileValue::dynCurrent:
+				return array.accumulateActive<TactileValue::dynCurrent, acc>(bMean);
+			case TactileValue::dynMean:
+				return array.accumulateActive<TactileValue::dynMean, acc>(bMean);
+			case TactileValue::dynCurrentRelease:
+				return array.accumulateActive<TactileValue::dynCurrentRelease, acc>(bMean);
+			case TactileValue::dynMeanRelease:
+				return array.accumulateActive<TactileValue::dynMeanRelease, acc>(bMean);
+		}
+		throw std::invalid_argument("invalid mode");
+	}
+};
+
+struct AccumulateAccessor
+{
+	template <TactileValueArray::AccMode acc>
+	static float call(const TactileValueArray &array,
+	                  const TactileValueArray::AccessorFunction &accessor, bool bMean)
+	{
+		return array.accumulate<acc>(accessor, bMean);
+	}
+};
+}  // namespace
 
 float TactileValueArray::accumulate(const vector_data &data, AccMode mode, bool bMean)
 {
-	float result = std::accumulate(data.begin(), data.end(), INITIAL[mode], ACCUMULATORS[mode]);
-	if (bMean && !data.empty()) result /= data.size();
-	return result;
+	if (mode == Median) return quantile(data, 0.5f);
+	return dispatch<AccumulateData>(mode, data, bMean);
 }
 
-float TactileValueArray::accumulate(TactileValue::Mode mode, AccMode acc_mode, bool bMean)
+float TactileValueArray::accumulate(TactileValue::Mode mode, AccMode acc_mode, bool bMean) const
 {
-	return accumulate([mode](const TactileValue &self) { return self.value(mode); }, acc_mode,
-	                  bMean);
+	if (acc_mode == Median) return quantile(mode, 0.5f);
+	return dispatch<AccumulateMode>(acc_mode, *this, mode, bMean);
 }
 
 float TactileValueArray::accumulate(const AccessorFunction &accessor, AccMode mode,
                                     bool bMean) const
 {
-	float result = INITIAL[mode];
-	AccumulatorFunction acc = ACCUMULATORS[mode];
-	for (const auto &sensor : vSensors)
-		result = acc(result, accessor(sensor));
-	if (bMean && !vSensors.empty()) result /= vSensors.size();
-	return result;
+	if (mode == Median) {
+		float *values = scratch(n);
+		for (size_t i = 0; i < n; ++i)
+			values[i] = accessor((*this)[i]);
+		return selectQuantile(values, values + n, 0.5f);
+	}
+	return dispatch<AccumulateAccessor>(mode, *this, accessor, bMean);
 }
 
-void TactileValueArray::setMeanLambda(float fLambda)
+float TactileValueArray::accumulateActive(TactileValue::Mode mode, AccMode acc_mode,
+                                          bool bMean) const
 {
-	for (auto &sensor : vSensors)
-		sensor.setMeanLambda(fLambda);
+	if (acc_mode == Median) {
+		// values of all taxels in [0, n), compacted values of active ones behind
+		float *values = scratch(n + vActive.size());
+		float *active = values + n;
+		getActiveValues(mode, values);
+		for (size_t k = 0; k < vActive.size(); ++k)
+			active[k] = values[vActive[k]];
+		return selectQuantile(active, active + vActive.size(), 0.5f);
+	}
+	return dispatch<AccumulateActive>(acc_mode, *this, mode, bMean);
 }
-void TactileValueArray::setRangeLambda(float fLambda)
+
+void TactileValueArray::getActiveValues(TactileValue::Mode mode, float *values) const
 {
-	for (auto &sensor : vSensors)
-		sensor.setRangeLambda(fLambda);
+	switch (mode) {
+		case TactileValue::rawCurrent: return getActiveValues<TactileValue::rawCurrent>(values);
+		case TactileValue::rawMean: return getActiveValues<TactileValue::rawMean>(values);
+		case TactileValue::absCurrent: return getActiveValues<TactileValue::absCurrent>(values);
+		case TactileValue::absMean: return getActiveValues<TactileValue::absMean>(values);
+		case TactileValue::dynCurrent: return getActiveValues<TactileValue::dynCurrent>(values);
+		case TactileValue::dynMean: return getActiveValues<TactileValue::dynMean>(values);
+		case TactileValue::dynCurrentRelease:
+			return getActiveValues<TactileValue::dynCurrentRelease>(values);
+		case TactileValue::dynMeanRelease:
+			return getActiveValues<TactileValue::dynMeanRelease>(values);
+	}
 }
-void TactileValueArray::setReleaseDecay(float fDecay)
+
+TactileValueArray::Accumulation TactileValueArray::accumulateAll(TactileValue::Mode mode,
+                                                                bool bMean) const
 {
-	for (auto &sensor : vSensors)
-		sensor.setReleaseDecay(fDecay);
+	switch (mode) {
+		case TactileValue::rawCurrent: return accumulateAll<TactileValue::rawCurrent>(bMean);
+		case TactileValue::rawMean: return accumulateAll<TactileValue::rawMean>(bMean);
+		case TactileValue::absCurrent: return accumulateAll<TactileValue::absCurrent>(bMean);
+		case TactileValue::absMean: return accumulateAll<TactileValue::absMean>(bMean);
+		case TactileValue::dynCurrent: return accumulateAll<TactileValue::dynCurrent>(bMean);
+		case TactileValue::dynMean: return accumulateAll<TactileValue::dynMean>(bMean);
+		case TactileValue::dynCurrentRelease:
+			return accumulateAll<TactileValue::dynCurrentRelease>(bMean);
+		case TactileValue::dynMeanRelease: return accumulateAll<TactileValue::dynMeanRelease>(bMean);
+	}
+	throw std::invalid_argument("invalid mode");
 }
 
-float TactileValueArray::getMeanLambda() const
+void TactileValueArray::accumulateRegions(TactileValue::Mode mode,
+                                          std::vector<Accumulation> &results, bool bMean) const
 {
-	return accumulate([](const TactileValue &self) { return self.getMeanLambda(); }, Sum, true);
+	switch (mode) {
+		case TactileValue::rawCurrent:
+			return accumulateRegions<TactileValue::rawCurrent>(results, bMean);
+		case TactileValue::rawMean: return accumulateRegions<TactileValue::rawMean>(results, bMean);
+		case TactileValue::absCurrent:
+			return accumulateRegions<TactileValue::absCurrent>(results, bMean);
+		case TactileValue::absMean: return accumulateRegions<TactileValue::absMean>(results, bMean);
+		case TactileValue::dynCurrent:
+			return accumulateRegions<TactileValue::dynCurrent>(results, bMean);
+		case TactileValue::dynMean: return accumulateRegions<TactileValue::dynMean>(results, bMean);
+		case TactileValue::dynCurrentRelease:
+			return accumulateRegions<TactileValue::dynCurrentRelease>(results, bMean);
+		case TactileValue::dynMeanRelease:
+			return accumulateRegions<TactileValue::dynMeanRelease>(results, bMean);
+	}
 }
 
-float TactileValueArray::getRangeLambda() const
+std::vector<TactileValueArray::Override>::const_iterator TactileValueArray::findOverride(
+    size_t i) const
 {
-	return accumulate([](const TactileValue &self) { return self.getRangeLambda(); }, Sum, true);
+	return std::lower_bound(vOverrides.begin(), vOverrides.end(), i,
+	                        [](const Override &o, size_t i) { return o.taxel < i; });
 }
 
-float TactileValueArray::getReleaseDecay() const
+TactileValueArray::Override &TactileValueArray::override(size_t i)
+{
+	assert(i < n);
+	auto it = vOverrides.begin() + (findOverride(i) - vOverrides.begin());
+	if (it == vOverrides.end() || it->taxel != i)
+		it = vOverrides.insert(it, Override{ uint32_t(i), params, rates, false });
+	return *it;
+}
+
+TactileParams &TactileValueArray::fixedParameters(size_t i)
+{
+	Override &o = override(i);
+	o.bTimed = false;
+	return o.params;
+}
+
+const TactileParams &TactileValueArray::parameters(size_t i) const
+{
+	auto it = findOverride(i);
+	return it != vOverrides.end() && it->taxel == i ? it->params : params;
+}
+
+const TactileValueArray::TimeRates &TactileValueArray::timeRates(size_t i) const
+{
+	auto it = findOverride(i);
+	return it != vOverrides.end() && it->taxel == i ? it->rates : rates;
+}
+
+void TactileValueArray::setParameters(size_t i, const TactileParams &p)
+{
+	fixedParameters(i) = p;
+}
+
+void TactileValueArray::setMeanLambda(float fLambda)
+{
+	params.meanLambda = fLambda;
+	for (Override &o : vOverrides)
+		o.params.meanLambda = fLambda;
+}
+void TactileValueArray::setRangeLambda(float fLambda)
+{
+	params.rangeLambda = fLambda;
+	for (Override &o : vOverrides)
+		o.params.rangeLambda = fLambda;
+}
+void TactileValueArray::setReleaseDecay(float fDecay)
 {
-	return accumulate([](const TactileValue &self) { return self.getReleaseDecay(); }, Sum, true);
+	params.releaseDecay = fDecay;
+	for (Override &o : vOverrides)
+		o.params.releaseDecay = fDecay;
 }
 
 }  // namespace tactile
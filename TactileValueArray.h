@@ -24,22 +24,40 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <vector>
+#include <memory>
+#include <iterator>
+#include <type_traits>
 #include <functional>
 #include <assert.h>
+#include <math.h>
 #include "TactileValue.h"
+#include "TactileState.h"
+#include "CalibrationBank.h"
+#include "TaxelRegions.h"
+#include "StridedView.h"
 
 namespace tactile {
 
 /* Abstraction for an array of similar tactile sensing elements (tactels).
    This adds accumulation modes to aggregate all sensor values within the array
    into a single value.
+   The filter state of all taxels is stored as struct-of-arrays (see TactileState).
+   Individual taxels are accessed through proxy objects, mimicking the TactileValue API.
  */
 class TactileValueArray {
 public:
+	class ConstReference;
+	class Reference;
+	template <class Ref>
+	class Iterator;
+
 	using vector_data = std::vector<float>;
-	using const_iterator = std::vector<TactileValue>::const_iterator;
-	using iterator = std::vector<TactileValue>::iterator;
+	using reference = Reference;
+	using const_reference = ConstReference;
+	using iterator = Iterator<Reference>;
+	using const_iterator = Iterator<ConstReference>;
 
 	enum AccMode
 	{
@@ -50,92 +68,727 @@ public:
 		CountNegative,
 		Min,
 		Max,
+		Median,  // order statistic, computed by selection instead of reduction
 		lastMode
 	};
+	/// number of accumulation modes computed by reduction (all modes before Median)
+	static constexpr int NUM_REDUCTIONS = Median;
+
+	/// read-only proxy to a single taxel
+	class ConstReference {
+	public:
+		ConstReference(const TactileValueArray &array, size_t index) : array(&array), index(index) {}
+
+		float value(TactileValue::Mode mode) const;
+
+		float getMeanLambda() const { return array->parameters(index).meanLambda; }
+		float getRangeLambda() const { return array->parameters(index).rangeLambda; }
+		float getReleaseDecay() const { return array->parameters(index).releaseDecay; }
+
+		Range absRange() const;
+		Range dynRange() const;
+
+		std::shared_ptr<Calibration> getCalibration() const;
+
+		/// create a stand-alone copy of the taxel
+		operator TactileValue() const;
+
+	protected:
+		const TactileValueArray *array;
+		size_t index;
+	};
+
+	/// read-write proxy to a single taxel (constness of proxy doesn't propagate to taxel)
+	class Reference : public ConstReference {
+	public:
+		Reference(TactileValueArray &array, size_t index) : ConstReference(array, index) {}
+
+		void init(float fMin = FLT_MAX, float fMax = -FLT_MAX) const;
+		void update(float fNew) const;
+
+		/// setting parameters of a single taxel creates a per-taxel override
+		void setMeanLambda(float fLambda) const;
+		void setRangeLambda(float fLambda) const;
+		void setReleaseDecay(float fDecay) const;
+
+		void setCalibration(const std::shared_ptr<Calibration> &c) const;
+
+	private:
+		TactileValueArray &self() const { return const_cast<TactileValueArray &>(*array); }
+	};
+
+	/// random-access iterator over taxel proxies
+	template <class Ref>
+	class Iterator {
+		using Array = typename std::conditional<std::is_same<Ref, Reference>::value, TactileValueArray,
+		                                        const TactileValueArray>::type;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = TactileValue;
+		using difference_type = ptrdiff_t;
+		using reference = Ref;
+		struct pointer
+		{
+			Ref ref;
+			const Ref *operator->() const { return &ref; }
+		};
+
+		Iterator(Array &array, difference_type index) : array(&array), index(index) {}
+		/// allow conversion from iterator to const_iterator
+		template <class Other>
+		Iterator(const Iterator<Other> &other) : array(other.array), index(other.index)
+		{}
+
+		Ref operator*() const { return Ref(*array, index); }
+		pointer operator->() const { return pointer{ Ref(*array, index) }; }
+		Ref operator[](difference_type i) const { return Ref(*array, index + i); }
+
+		Iterator &operator++()
+		{
+			++index;
+			return *this;
+		}
+		Iterator &operator--()
+		{
+			--index;
+			return *this;
+		}
+		Iterator operator++(int) { return Iterator(*array, index++); }
+		Iterator operator--(int) { return Iterator(*array, index--); }
+		Iterator &operator+=(difference_type i)
+		{
+			index += i;
+			return *this;
+		}
+		Iterator &operator-=(difference_type i)
+		{
+			index -= i;
+			return *this;
+		}
+		Iterator operator+(difference_type i) const { return Iterator(*array, index + i); }
+		Iterator operator-(difference_type i) const { return Iterator(*array, index - i); }
+		difference_type operator-(const Iterator &other) const { return index - other.index; }
+
+		bool operator==(const Iterator &other) const { return index == other.index; }
+		bool operator!=(const Iterator &other) const { return index != other.index; }
+		bool operator<(const Iterator &other) const { return index < other.index; }
+		bool operator>(const Iterator &other) const { return index > other.index; }
+		bool operator<=(const Iterator &other) const { return index <= other.index; }
+		bool operator>=(const Iterator &other) const { return index >= other.index; }
+
+	private:
+		template <class Other>
+		friend class Iterator;
+
+		Array *array;
+		difference_type index;
+	};
 
 	/// initialize array of given size, with given default range
 	TactileValueArray(size_t n = 0, float min = FLT_MAX, float max = -FLT_MAX);
+	/// initialize array of n taxels operating on caller-owned storage of storageSize(capacity)
+	/// floats (aligned to CACHE_LINE_SIZE), e.g. within hugepage-backed or shared memory
+	/// The array can be resized up to capacity taxels, but never reallocates its state.
+	TactileValueArray(float *storage, size_t capacity, size_t n, float min = FLT_MAX,
+	                  float max = -FLT_MAX);
+	/// copies rebind the state to their own storage
+	TactileValueArray(const TactileValueArray& other);
+	TactileValueArray& operator=(const TactileValueArray& other);
+	/// moves take over the storage, leaving other as an empty array
+	TactileValueArray(TactileValueArray&& other);
+	TactileValueArray& operator=(TactileValueArray&& other);
 
 	/// initialize all taxels
+	/// Resizing within capacity() doesn't reallocate the state, keeping parameters of taxels.
 	void init(size_t n, float min = FLT_MAX, float max = -FLT_MAX);
+	/// ensure capacity for given number of taxels, throws std::length_error for external storage
+	void reserve(size_t capacity);
+	/// maximum number of taxels without reallocation
+	size_t capacity() const { return nCapacity; }
+	/// does the array operate on caller-owned storage?
+	bool external() const { return bExternal; }
+
+	/// number of floats of storage required for an array of up to capacity taxels
+	static size_t storageSize(size_t capacity)
+	{
+		return (TactileState::NUM_FIELDS + 1) * TactileState::stride(capacity);
+	}
+	/// number of floats required to store arrays of given capacities in a single block
+	static size_t storageSize(const std::vector<size_t>& capacities);
+	/// create arrays of given capacities, laid out consecutively within a single caller-owned
+	/// block of storageSize(capacities) floats (aligned to CACHE_LINE_SIZE)
+	static std::vector<TactileValueArray> createArrays(float* storage,
+	                                                   const std::vector<size_t>& capacities);
 	/// re-initialize all taxels
 	void reset(float min = FLT_MAX, float max = -FLT_MAX);
 
 	static AccMode getMode(const std::string& sName);
 	static std::string getModeName(AccMode m);
 
-	size_t size() const { return vSensors.size(); }
-	const TactileValue& operator[](size_t i) const { return vSensors[i]; }
-	TactileValue& operator[](size_t i) { return vSensors[i]; }
+	size_t size() const { return n; }
+	bool empty() const { return n == 0; }
+	ConstReference operator[](size_t i) const { return ConstReference(*this, i); }
+	Reference operator[](size_t i) { return Reference(*this, i); }
+
+	const_iterator begin() const { return const_iterator(*this, 0); }
+	const_iterator end() const { return const_iterator(*this, ptrdiff_t(n)); }
 
-	const_iterator begin() const { return vSensors.begin(); }
-	const_iterator end() const { return vSensors.end(); }
+	iterator begin() { return iterator(*this, 0); }
+	iterator end() { return iterator(*this, ptrdiff_t(n)); }
 
-	iterator begin() { return vSensors.begin(); }
-	iterator end() { return vSensors.end(); }
+	/// struct-of-arrays view onto the filter state of all taxels
+	const TactileState &data() const { return state; }
+
+	/// calibrations of all taxels
+	const CalibrationBank &calibrations() const { return calib; }
+	CalibrationBank &calibrations() { return calib; }
+	/// load calibrations from YAML file (see CalibrationBank::load), resizing an empty array
+	void loadCalibrations(const std::string &sYAMLFile);
+
+	/// named regions of taxels
+	const TaxelRegions &regions() const { return taxelRegions; }
+	TaxelRegions &regions() { return taxelRegions; }
+	/// load regions from YAML file (see TaxelRegions::load), resizing an empty array
+	void loadRegions(const std::string &sYAMLFile);
 
 	/// update from values [first, last) copying to internal buffer + offset
+	/// Contiguous ranges of raw uint16_t or int16_t (ADC) codes are passed to the calibrations
+	/// without conversion to float, allowing for direct table lookup (see LookupTableCalib).
+	/// Updates of disjoint taxel ranges of an initialized array may run concurrently,
+	/// provided the calibration runs are up to date (see CalibrationBank::runs()).
 	template <class InputIterator>
 	void updateValues(InputIterator first, InputIterator last, ptrdiff_t offset = 0)
 	{
-		// resize vSensors if not yet initialized
-		if (vSensors.empty() && offset >= 0) init(last - first + offset);
+		const ptrdiff_t count = last - first;
+		// resize if not yet initialized
+		if (empty() && offset >= 0) init(count + offset);
 
 		// start from begin() (when offset >= 0) or from end() (otherwise)
-		iterator start = offset >= 0 ? begin() + offset : end() + offset;
-		assert(start >= begin() && start + (last - first) <= end());
-
-		for (; first != last; ++first, ++start)
-			start->update(*first);
+		const ptrdiff_t start = offset >= 0 ? offset : ptrdiff_t(n) + offset;
+		assert(start >= 0 && start + count <= ptrdiff_t(n));
+		updateValues(first, start, count, IsCodeIterator<InputIterator>());
 	}
 	/// convenience method to update from all values in source vector
+	/// Views into packet buffers (StridedView, IndexedView) are consumed in place.
 	template <class Iteratable>
 	void updateValues(const Iteratable& source, ptrdiff_t offset = 0)
 	{
 		updateValues(source.begin(), source.end(), offset);
 	}
 
+	/// update from nFrames consecutive frames data[f * stride + (0, size())], e.g. when replaying logs
+	/// Equivalent to calling updateValues() for each frame, but much faster as the filter runs
+	/// taxel-major, keeping the state of a taxel in registers across frames.
+	/// An uninitialized array is resized to stride taxels.
+	void updateFrames(const float *data, size_t nFrames, size_t stride);
+
+	/// Sparse updates: inputs differing by less than a taxel's deadband from its current value
+	/// are skipped, leaving the taxel's state (and thus its values) unchanged. Updated taxels are
+	/// recorded in an active set (bitset + index list), such that consumers can process changes only.
+	/// Sparse mode is enabled by any positive deadband. It doesn't support concurrent updates of
+	/// disjoint ranges (TactileSkin updates sparse arrays as a whole) and isn't applied by
+	/// updateFrames().
+	void setDeadband(float fDeadband);
+	void setDeadband(size_t i, float fDeadband);
+	float getDeadband(size_t i) const { return bSparse ? vDeadband[i] : 0.f; }
+	bool sparse() const { return bSparse; }
+
+	/// indices of taxels updated since the last clearActive() (sparse mode only), in update order
+	const std::vector<uint32_t>& activeTaxels() const { return vActive; }
+	bool isActive(size_t i) const { return bSparse && (vActiveBits[i / 64] >> (i % 64)) & 1; }
+	/// reset active set, e.g. after processing a frame
+	void clearActive();
+	/// copy values of given mode of active taxels into values[i], leaving other values untouched
+	void getActiveValues(TactileValue::Mode mode, float *values) const;
+	template <TactileValue::Mode mode>
+	void getActiveValues(float *values) const
+	{
+		const TactileState s = state;
+		for (uint32_t i : vActive)
+			values[i] = value<mode>(s, i);
+	}
+	/// Lazy decay in sparse mode: frames skipped by a taxel count as repetitions of its current
+	/// value, which are applied in closed form before the taxel's next update or by catchUp().
+	/// Afterwards, the taxel's state equals (up to rounding) that of a dense update with held values.
+	void setLazyDecay(bool bLazy) { bLazyDecay = bLazy; }
+	bool lazyDecay() const { return bLazyDecay; }
+	/// number of skipped frames of taxel i not yet applied
+	unsigned int pending(size_t i) const { return bSparse ? vPending[i] : 0; }
+	/// apply pending frames of all taxels, e.g. before reading values
+	void catchUp();
+	/// apply nFrames filter steps with unchanged input (the current values) to all taxels in closed
+	/// form, e.g. for frames dropped by decimation
+	void repeat(unsigned int nFrames);
+
+	/// Timestamped updates: filter parameters are given as time constants (in seconds) and a
+	/// release rate (per second), from which updateValuesAt() derives the lambdas for the time
+	/// elapsed since the previous frame (see TactileValue::updateElapsed()). Thus the filter
+	/// response doesn't depend on the frame rate and dropped frames are accounted for.
+	/// Defaults correspond to the default lambdas at 1 kHz. Like the lambdas, time constants are
+	/// shared by all taxels, setting them for a single taxel creates an override.
+	/// Lambdas explicitly set for a single taxel (e.g. by setParameters(i, p)) are kept as given,
+	/// until time constants are set for that taxel.
+	void setTimeConstants(float fMeanTau, float fRangeTau, float fReleaseRate);
+	void setTimeConstants(size_t i, float fMeanTau, float fRangeTau, float fReleaseRate);
+	float getMeanTau(size_t i) const { return 1.f / timeRates(i).mean; }
+	float getRangeTau(size_t i) const { return 1.f / timeRates(i).range; }
+	float getReleaseRate(size_t i) const { return timeRates(i).release; }
+	/// update all taxels from frame [first, last) acquired at given timestamp (in seconds)
+	template <class InputIterator>
+	void updateValuesAt(InputIterator first, InputIterator last, double timestamp)
+	{
+		if (empty()) init(last - first);
+		assert(size_t(last - first) == n);
+		applyElapsed(timestamp);
+		updateValues(first, last);
+	}
+	template <class Iteratable>
+	void updateValuesAt(const Iteratable& source, double timestamp)
+	{
+		updateValuesAt(source.begin(), source.end(), timestamp);
+	}
+
+	/// accumulate values of given mode of active taxels only
+	float accumulateActive(TactileValue::Mode mode, AccMode acc_mode = Sum, bool bMean = true) const;
+
+	/// compute value of given mode for taxel i of state s, branch-free w.r.t. taxel state
+	template <TactileValue::Mode mode>
+	static float value(const TactileState &s, size_t i)
+	{
+		if (mode == TactileValue::rawCurrent) return s.cur[i];
+		if (mode == TactileValue::rawMean) return s.mean[i];
+
+		constexpr bool abs = mode == TactileValue::absCurrent || mode == TactileValue::absMean;
+		const float fMin = abs ? s.absMin[i] : s.dynMin[i];
+		const float fRange = (abs ? s.absMax[i] : s.dynMax[i]) - fMin;
+		// do not divide by zero: dividing by NAN yields NAN too
+		return unscaledValue<mode>(s, i, fMin) / (fRange < FLT_EPSILON ? NAN : fRange);
+	}
+	/// value of given (non-raw) mode relative to range minimum fMin, not yet divided by the range
+	template <TactileValue::Mode mode>
+	static float unscaledValue(const TactileState &s, size_t i, float fMin)
+	{
+		constexpr bool mean = mode == TactileValue::absMean || mode == TactileValue::dynMean ||
+		                      mode == TactileValue::dynMeanRelease;
+		constexpr bool release = mode >= TactileValue::dynCurrentRelease;
+
+		// select operands (instead of results) of floating-point operations to keep the loop
+		// vectorizable: if-conversion of (potentially trapping) operations is not possible
+		const float fReleased = s.released[i];
+		const float fValue = mean ? s.mean[i] : s.cur[i];
+		const float fSign = release && fReleased != FLT_MAX ? -1.f : 1.f;
+		return fSign * ((fSign < 0 ? fReleased : fValue) - fMin);
+	}
+
+	/// copy values of compile-time mode beginning from offset into output iterator [first, last)
+	template <TactileValue::Mode mode, typename OutputIterator>
+	void getValues(OutputIterator first, OutputIterator last, ptrdiff_t offset = 0) const
+	{
+		// start from begin() (when offset >= 0) or from end() (otherwise)
+		const ptrdiff_t start = offset >= 0 ? offset : ptrdiff_t(n) + offset;
+		const ptrdiff_t count = last - first;
+		assert(start >= 0 && start + count <= ptrdiff_t(n));
+		const TactileState s = state + start;
+		for (ptrdiff_t i = 0; i < count; ++i)
+			first[i] = value<mode>(s, i);
+	}
+	/// convenience method to copy values of compile-time mode into target vector
+	template <TactileValue::Mode mode, class Iteratable>
+	void getValues(Iteratable& target, ptrdiff_t offset = 0) const
+	{
+		// resize target vector if not yet initialized
+		if (target.empty()) target.resize(n);
+		getValues<mode>(target.begin(), target.end(), offset);
+	}
+
 	/// copy values beginning from offset into output iterator [first, last)
 	template <typename OutputIterator>
 	void getValues(TactileValue::Mode mode, OutputIterator first, OutputIterator last,
 	               ptrdiff_t offset = 0) const
 	{
-		// start from begin() (when offset >= 0) or from end() (otherwise)
-		const_iterator start = offset >= 0 ? begin() + offset : end() + offset;
-		assert(start >= begin() && start + (last - first) <= end());
-		for (; first != last; ++first, ++start)
-			*first = start->value(mode);
+		// dispatch mode once for all taxels
+		switch (mode) {
+			case TactileValue::rawCurrent:
+				return getValues<TactileValue::rawCurrent>(first, last, offset);
+			case TactileValue::rawMean: return getValues<TactileValue::rawMean>(first, last, offset);
+			case TactileValue::absCurrent:
+				return getValues<TactileValue::absCurrent>(first, last, offset);
+			case TactileValue::absMean: return getValues<TactileValue::absMean>(first, last, offset);
+			case TactileValue::dynCurrent:
+				return getValues<TactileValue::dynCurrent>(first, last, offset);
+			case TactileValue::dynMean: return getValues<TactileValue::dynMean>(first, last, offset);
+			case TactileValue::dynCurrentRelease:
+				return getValues<TactileValue::dynCurrentRelease>(first, last, offset);
+			case TactileValue::dynMeanRelease:
+				return getValues<TactileValue::dynMeanRelease>(first, last, offset);
+		}
 	}
 	/// convenience method to copy values with given mode into target vector
 	template <class Iteratable>
 	void getValues(TactileValue::Mode mode, Iteratable& target, ptrdiff_t offset = 0) const
 	{
 		// resize target vector if not yet initialized
-		if (target.empty()) target.resize(vSensors.size());
+		if (target.empty()) target.resize(n);
 		getValues(mode, target.begin(), target.end(), offset);
 	}
 
+	/// output buffer for getValues() of multiple modes
+	struct ModeOutput
+	{
+		TactileValue::Mode mode;
+		float *values;
+	};
+	/// fill values of several modes for count taxels beginning from offset in a single pass
+	void getValues(const std::vector<ModeOutput>& outputs, size_t count, ptrdiff_t offset = 0) const;
+
 	/// return values with given mode into new vector v
 	vector_data getValues(TactileValue::Mode mode) const;
 
-	/// accumulate values in data vector
+	/// accumulate values in data vector (bMean is ignored for Median)
 	static float accumulate(const vector_data& data, AccMode mode = Sum, bool bMean = true);
-	using AccessorFunction = std::function<float(const TactileValue&)>;
+	using AccessorFunction = std::function<float(const ConstReference&)>;
 	/// retrieve values with given mode and accumulate them with acc_mode
-	float accumulate(TactileValue::Mode mode, AccMode acc_mode = Sum, bool bMean = true);
+	float accumulate(TactileValue::Mode mode, AccMode acc_mode = Sum, bool bMean = true) const;
 	/// accumulate values in taxels accessed through accessor function
 	float accumulate(const AccessorFunction& accessor, AccMode mode = Sum, bool bMean = true) const;
 
+	/// accumulate values in data vector with compile-time acc mode
+	template <AccMode acc>
+	static float accumulate(const vector_data& data, bool bMean = true)
+	{
+		const float* d = data.data();
+		return normalize(reduce<acc>([d](size_t i) { return d[i]; }, data.size()), data.size(),
+		                 bMean);
+	}
+	/// retrieve values with compile-time mode and accumulate them with compile-time acc mode
+	template <TactileValue::Mode mode, AccMode acc>
+	float accumulate(bool bMean = true) const
+	{
+		const TactileState s = state;
+		return normalize(reduce<acc>([s](size_t i) { return value<mode>(s, i); }, n), n, bMean);
+	}
+	/// accumulate values of taxels accessed through accessor(const ConstReference&),
+	/// which - as well as acc mode - is known at compile time and thus can be inlined
+	template <AccMode acc, typename Accessor>
+	float accumulate(Accessor accessor, bool bMean = true) const
+	{
+		return normalize(reduce<acc>([this, &accessor](size_t i) { return accessor((*this)[i]); }, n),
+		                 n, bMean);
+	}
+
+	/// accumulate values of compile-time mode of active taxels with compile-time acc mode
+	template <TactileValue::Mode mode, AccMode acc>
+	float accumulateActive(bool bMean = true) const
+	{
+		const TactileState s = state;
+		const uint32_t* active = vActive.data();
+		const size_t count = vActive.size();
+		return normalize(
+		    reduce<acc>([s, active](size_t k) { return value<mode>(s, active[k]); }, count), count,
+		    bMean);
+	}
+
+	/// results of all reduction modes (Sum ... Max)
+	struct Accumulation
+	{
+		float values[NUM_REDUCTIONS];
+		float operator[](AccMode acc) const { return values[acc]; }
+	};
+	/// accumulate values of given mode with all reduction modes in a single pass
+	/// Each field equals the result of accumulate(mode, acc, bMean).
+	Accumulation accumulateAll(TactileValue::Mode mode, bool bMean = true) const;
+	/// accumulate values of compile-time mode with all AccModes in a single pass
+	template <TactileValue::Mode mode>
+	Accumulation accumulateAll(bool bMean = true) const
+	{
+		const TactileState s = state;
+		Accumulation result = reduceAll([s](size_t i) { return value<mode>(s, i); }, n);
+		for (float& v : result.values)
+			v = normalize(v, n, bMean);
+		return result;
+	}
+
+	/// accumulate values of given mode with all reduction modes for all regions in a single traversal
+	/// results[r] holds the accumulation of region r, results[0] the one of taxels w/o region.
+	/// With bMean, each result is normalized by the number of taxels in its region.
+	void accumulateRegions(TactileValue::Mode mode, std::vector<Accumulation>& results,
+	                       bool bMean = true) const;
+	/// accumulate values of compile-time mode for all regions
+	template <TactileValue::Mode mode>
+	void accumulateRegions(std::vector<Accumulation>& results, bool bMean = true) const
+	{
+		// allocates only if the number of regions changed
+		results.assign(taxelRegions.numRegions(), initialAll());
+		const TactileState s = state;
+		auto get = [s](size_t i) { return value<mode>(s, i); };
+		// segmented reduction over runs of taxels sharing the same region
+		for (const TaxelRegions::Run& run : taxelRegions.runs()) {
+			Accumulation& result = results[run.index];
+			result = combineAll(result, reduceAll(get, run.end - run.begin, run.begin));
+		}
+		for (size_t r = 0; r < results.size(); ++r)
+			for (float& v : results[r].values)
+				v = normalize(v, taxelRegions.count(r), bMean);
+	}
+
+	/// q-quantile (0 <= q <= 1) of values of given mode, ignoring NaNs
+	/// Linearly interpolates between order statistics, which are found by selection in linear
+	/// time on a per-thread scratch buffer (allocating only when the array grows).
+	float quantile(TactileValue::Mode mode, float q) const;
+	/// q-quantile of values in data vector, ignoring NaNs
+	static float quantile(const vector_data& data, float q);
+
+	/// count values of given mode into bins of equal width covering [lo, hi)
+	/// The number of bins is given by the size of bins, values outside [lo, hi) are counted into
+	/// the first or last bin respectively, NaNs are ignored.
+	void histogram(TactileValue::Mode mode, float lo, float hi, std::vector<size_t>& bins) const;
+	/// count values of data vector into bins of equal width covering [lo, hi)
+	static void histogram(const vector_data& data, float lo, float hi, std::vector<size_t>& bins);
+
+	/// Filter parameters are shared by all taxels, except for sparse per-taxel overrides.
+	/// Taxels are filtered in runs sharing the same parameters, thus overrides should be few.
+	const TactileParams &parameters() const { return params; }
+	void setParameters(const TactileParams &p) { params = p; }
+	/// effective parameters of taxel i
+	const TactileParams &parameters(size_t i) const;
+	/// override parameters of taxel i
+	void setParameters(size_t i, const TactileParams &p);
+	/// number of taxels with overridden parameters
+	size_t numOverrides() const { return vOverrides.size(); }
+	/// reset all taxels to the shared parameters
+	void clearOverrides() { vOverrides.clear(); }
+
+	/// set parameter of all taxels (shared and overrides)
 	void setMeanLambda(float fLambda);
 	void setRangeLambda(float fLambda);
 	void setReleaseDecay(float fDecay);
 
-	float getMeanLambda() const;
-	float getRangeLambda() const;
-	float getReleaseDecay() const;
+	/// shared parameters
+	float getMeanLambda() const { return params.meanLambda; }
+	float getRangeLambda() const { return params.rangeLambda; }
+	float getReleaseDecay() const { return params.releaseDecay; }
 
 private:
-	std::vector<TactileValue> vSensors;
+	friend class StateCheckpoint;
+
+	static constexpr size_t LANES = 16;         // independent lanes of reductions
+	static constexpr size_t BLOCK = 16 * LANES;  // block size of pairwise reduction
+
+	/// initial value of reduction acc
+	template <AccMode acc>
+	static constexpr float initial()
+	{
+		return acc == Min ? FLT_MAX : acc == Max ? -FLT_MAX : 0.f;
+	}
+	/// accumulate value c into result, w/o branches to allow vectorization
+	template <AccMode acc>
+	static float step(float result, float c)
+	{
+		switch (acc) {
+			case Sum: return result + c;
+			case SumPositive: return result + (c > 0 ? c : 0.f);
+			case SumNegative: return result + (c < 0 ? c : 0.f);
+			case CountPositive: return result + (c > 0 ? 1.f : 0.f);
+			case CountNegative: return result + (c < 0 ? 1.f : 0.f);
+			case Min: return c < result ? c : result;
+			case Max: return c > result ? c : result;
+			case Median:
+			case lastMode: break;
+		}
+		return result;
+	}
+	/// combine two partial results of reduction acc
+	template <AccMode acc>
+	static float combine(float a, float b)
+	{
+		return acc == Min ? (b < a ? b : a) : acc == Max ? (b > a ? b : a) : a + b;
+	}
+	/// reduce get(i) for i in [0, count) with reduction acc
+	/// Several independent lanes allow for vectorization, the pairwise combination of blocks
+	/// limits the growth of rounding errors of sums to O(log count).
+	template <AccMode acc, typename Getter>
+	static float reduce(const Getter& get, size_t count, size_t offset = 0)
+	{
+		static_assert(acc < NUM_REDUCTIONS, "not a reduction mode");
+		if (count > BLOCK) {
+			const size_t half = split(count);
+			return combine<acc>(reduce<acc>(get, half, offset),
+			                    reduce<acc>(get, count - half, offset + half));
+		}
+		float lanes[LANES];
+		for (size_t j = 0; j < LANES; ++j)
+			lanes[j] = initial<acc>();
+		size_t i = 0;
+		for (; i + LANES <= count; i += LANES)
+			for (size_t j = 0; j < LANES; ++j)
+				lanes[j] = step<acc>(lanes[j], get(offset + i + j));
+		for (size_t j = 0; i < count; ++i, ++j)
+			lanes[j] = step<acc>(lanes[j], get(offset + i));
+		for (size_t width = LANES / 2; width > 0; width /= 2)
+			for (size_t j = 0; j < width; ++j)
+				lanes[j] = combine<acc>(lanes[j], lanes[j + width]);
+		return lanes[0];
+	}
+
+	/// reduce get(i) for i in [0, count) with all reductions, mirroring reduce<acc>() per field:
+	/// values of a block are computed once into a buffer, which is then reduced by each acc mode
+	template <typename Getter>
+	static Accumulation reduceAll(const Getter& get, size_t count, size_t offset = 0)
+	{
+		Accumulation result;
+		if (count > BLOCK) {
+			const size_t half = split(count);
+			return combineAll(reduceAll(get, half, offset),
+			                  reduceAll(get, count - half, offset + half));
+		}
+		float block[BLOCK];
+		for (size_t i = 0; i < count; ++i)
+			block[i] = get(offset + i);
+		auto buffered = [&block](size_t i) { return block[i]; };
+		result.values[Sum] = reduce<Sum>(buffered, count);
+		result.values[SumPositive] = reduce<SumPositive>(buffered, count);
+		result.values[SumNegative] = reduce<SumNegative>(buffered, count);
+		result.values[CountPositive] = reduce<CountPositive>(buffered, count);
+		result.values[CountNegative] = reduce<CountNegative>(buffered, count);
+		result.values[Min] = reduce<Min>(buffered, count);
+		result.values[Max] = reduce<Max>(buffered, count);
+		return result;
+	}
+	/// initial values of all reductions
+	static Accumulation initialAll()
+	{
+		Accumulation result;
+		for (int acc = 0; acc < NUM_REDUCTIONS; ++acc)
+			result.values[acc] = acc == Min ? FLT_MAX : acc == Max ? -FLT_MAX : 0.f;
+		return result;
+	}
+	/// combine two partial results of all reductions
+	static Accumulation combineAll(const Accumulation& a, const Accumulation& b)
+	{
+		Accumulation result;
+		result.values[Sum] = combine<Sum>(a[Sum], b[Sum]);
+		result.values[SumPositive] = combine<SumPositive>(a[SumPositive], b[SumPositive]);
+		result.values[SumNegative] = combine<SumNegative>(a[SumNegative], b[SumNegative]);
+		result.values[CountPositive] = combine<CountPositive>(a[CountPositive], b[CountPositive]);
+		result.values[CountNegative] = combine<CountNegative>(a[CountNegative], b[CountNegative]);
+		result.values[Min] = combine<Min>(a[Min], b[Min]);
+		result.values[Max] = combine<Max>(a[Max], b[Max]);
+		return result;
+	}
+	/// maximum number of frames calibrated at once by updateFrames()
+	static constexpr size_t FRAME_BATCH = 16;
+
+	/// split count into two halves, the first one being a multiple of LANES
+	static size_t split(size_t count) { return (count / 2 + LANES - 1) / LANES * LANES; }
+
+	static float normalize(float result, size_t count, bool bMean)
+	{
+		return bMean && count > 0 ? result / count : result;
+	}
+
+	/// contiguous iterator over raw uint16_t or int16_t codes?
+	template <class It, class T = typename std::iterator_traits<It>::value_type>
+	using IsCodeIterator = std::integral_constant<
+	    bool, (std::is_same<T, uint16_t>::value || std::is_same<T, int16_t>::value) &&
+	              (std::is_pointer<It>::value ||
+	               std::is_same<It, typename std::vector<T>::iterator>::value ||
+	               std::is_same<It, typename std::vector<T>::const_iterator>::value)>;
+
+	/// generic input: convert into flat float frame, then update in a tight loop
+	template <class InputIterator>
+	void updateValues(InputIterator first, size_t start, size_t count, std::false_type /*unused*/)
+	{
+		float *frame = pFrame + start;
+		for (size_t i = 0; i < count; ++i, ++first)
+			frame[i] = *first;
+		updateFrame(start, count);
+	}
+	/// contiguous integer codes: calibrate directly from input
+	template <class InputIterator>
+	void updateValues(InputIterator first, size_t start, size_t count, std::true_type /*unused*/)
+	{
+		if (count) updateCodes(&*first, start, count);
+	}
+
+	/// inverse time constants and release rate, see setTimeConstants()
+	struct TimeRates
+	{
+		float mean = 1.f / TactileValue::DEFAULT_MEAN_TAU;
+		float range = 1.f / TactileValue::DEFAULT_RANGE_TAU;
+		float release = TactileValue::DEFAULT_RELEASE_RATE;
+	};
+	/// parameters of a single taxel, deviating from the shared ones
+	struct Override
+	{
+		uint32_t taxel;
+		TactileParams params;
+		TimeRates rates;
+		bool bTimed;  // lambdas derived from rates by updateValuesAt()?
+	};
+	/// find override of taxel i (or the insertion position)
+	std::vector<Override>::const_iterator findOverride(size_t i) const;
+	/// override of taxel i, created from shared parameters if not yet present
+	Override &override(size_t i);
+	/// explicitly set lambdas of taxel i, which are kept by updateValuesAt()
+	TactileParams &fixedParameters(size_t i);
+	const TimeRates &timeRates(size_t i) const;
+
+	/// call fn(begin, end, params) for all runs of taxels sharing the same parameters within
+	/// [start, start+count), passing taxel indices relative to start
+	template <typename Function>
+	void forEachParamRun(size_t start, size_t count, Function fn) const
+	{
+		const size_t end = start + count;
+		size_t begin = start;
+		for (auto it = findOverride(start); it != vOverrides.end() && it->taxel < end; ++it) {
+			if (it->taxel > begin) fn(begin - start, it->taxel - start, params);
+			fn(it->taxel - start, it->taxel + 1 - start, it->params);
+			begin = it->taxel + 1;
+		}
+		if (begin < end) fn(begin - start, end - start, params);
+	}
+
+	/// bind state and frame buffer to storage of storageSize(capacity) floats
+	void bind(float *storage, size_t capacity);
+	/// filter taxels [start, start+count) with values stored in pFrame[start, start+count)
+	void updateFrame(size_t start, size_t count);
+	/// apply filter to calibrated values in pFrame[start, start+count), respecting deadbands
+	void filter(size_t start, size_t count);
+	/// filter all of pFrame[start, start+count) in runs of taxels sharing parameters
+	void filterDense(size_t start, size_t count);
+	/// filter nFrames frames data[f * stride + (0, n)] in runs of taxels sharing parameters
+	void filterFrames(const float *data, size_t nFrames, size_t stride);
+	/// allocate sparse-mode buffers for current capacity
+	void reserveSparse();
+	/// set lambdas of all taxels for the time elapsed since the previous timestamp
+	void applyElapsed(double timestamp);
+	/// filter taxels [start, start+count) with raw codes
+	void updateCodes(const uint16_t *codes, size_t start, size_t count);
+	void updateCodes(const int16_t *codes, size_t start, size_t count);
+
+	size_t n = 0;
+	size_t nCapacity = 0;
+	TactileState state;
+	float *pStorage = nullptr;                             // memory block holding state + frame
+	float *pFrame = nullptr;                               // input frame buffer within pStorage
+	bool bExternal = false;                                // storage owned by caller?
+	std::vector<float, AlignedAllocator<float>> vStorage;  // own storage (if not external)
+	bool bSparse = false;                                  // any deadband set?
+	std::vector<float> vDeadband;                          // per-taxel deadband (sparse mode)
+	std::vector<uint64_t> vActiveBits;                     // active taxels as bitset
+	std::vector<uint32_t> vActive;                         // active taxels as index list
+	std::vector<uint32_t> vUpdate;                         // taxels to update in filter()
+	std::vector<uint8_t> vFlags;                           // update flags of filter()
+	bool bLazyDecay = false;                               // count skipped frames?
+	std::vector<uint32_t> vPending;                        // skipped frames not yet applied
+	TactileParams params;                                  // shared filter parameters
+	TimeRates rates;                                       // shared time constants
+	std::vector<Override> vOverrides;                      // per-taxel parameters, sorted by taxel
+	double dLastTimestamp = NAN;                           // timestamp of previous frame
+	std::vector<float, AlignedAllocator<float>> vBatch;    // calibrated frames of updateFrames()
+	CalibrationBank calib;                                 // per-taxel calibration
+	TaxelRegions taxelRegions;                             // named regions of taxels
 };
 
 }  // namespace tactile
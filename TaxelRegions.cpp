@@ -0,0 +1,151 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "TaxelRegions.h"
+#include <assert.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#ifdef HAVE_YAML
+#include <yaml-cpp/yaml.h>
+#endif
+
+namespace tactile {
+
+void TaxelRegions::resize(size_t n)
+{
+	if (vNames.empty()) vNames.push_back("");
+	vIndices.resize(n, 0);
+	update();
+}
+
+void TaxelRegions::reserve(size_t n)
+{
+	vIndices.reserve(n);
+	vRuns.reserve(n);  // at most one run per taxel
+	vCounts.reserve(vNames.size());
+}
+
+void TaxelRegions::clear()
+{
+	vNames.resize(1);
+	std::fill(vIndices.begin(), vIndices.end(), 0);
+	update();
+}
+
+TaxelRegions::Index TaxelRegions::find(const std::string &sName) const
+{
+	auto it = std::find(vNames.begin() + 1, vNames.end(), sName);
+	return it == vNames.end() ? 0 : it - vNames.begin();
+}
+
+TaxelRegions::Index TaxelRegions::add(const std::string &sName)
+{
+	if (Index index = find(sName)) return index;
+	if (vNames.size() > std::numeric_limits<Index>::max())
+		throw std::length_error("too many regions");
+	vNames.push_back(sName);
+	vCounts.push_back(0);
+	return vNames.size() - 1;
+}
+
+void TaxelRegions::set(size_t first, size_t last, Index index)
+{
+	assert(first <= last && last <= vIndices.size() && index < vNames.size());
+	std::fill(vIndices.begin() + first, vIndices.begin() + last, index);
+	update();
+}
+
+void TaxelRegions::set(const std::vector<size_t> &taxels, Index index)
+{
+	assert(index < vNames.size());
+	for (size_t taxel : taxels) {
+		assert(taxel < vIndices.size());
+		vIndices[taxel] = index;
+	}
+	update();
+}
+
+void TaxelRegions::set(const std::vector<bool> &mask, Index index)
+{
+	assert(mask.size() <= vIndices.size() && index < vNames.size());
+	for (size_t taxel = 0; taxel < mask.size(); ++taxel)
+		if (mask[taxel]) vIndices[taxel] = index;
+	update();
+}
+
+void TaxelRegions::update()
+{
+	vCounts.assign(vNames.size(), 0);
+	vRuns.clear();
+	for (size_t i = 0, end; i < vIndices.size(); i = end) {
+		for (end = i + 1; end < vIndices.size() && vIndices[end] == vIndices[i]; ++end)
+			;
+		vRuns.push_back(Run{ i, end, vIndices[i] });
+		vCounts[vIndices[i]] += end - i;
+	}
+}
+
+const std::string NO_YAML_SUPPORT("compiled without YAML support");
+void TaxelRegions::load(const YAML::Node &node)
+{
+#ifdef HAVE_YAML
+	// each entry assigns taxels to a named region: an inclusive range [first, last],
+	// a list of indices, and/or a bitmask (list of 0/1 starting at taxel 0)
+	for (const YAML::Node &entry : node["regions"]) {
+		const Index index = add(entry["name"].as<std::string>());
+		if (entry["range"]) {
+			const YAML::Node &range = entry["range"];
+			const size_t last = range[1].as<size_t>() + 1;
+			if (last > size()) resize(last);
+			set(range[0].as<size_t>(), last, index);
+		}
+		if (entry["indices"]) {
+			const std::vector<size_t> taxels = entry["indices"].as<std::vector<size_t>>();
+			for (size_t taxel : taxels)
+				if (taxel >= size()) resize(taxel + 1);
+			set(taxels, index);
+		}
+		if (entry["mask"]) {
+			std::vector<bool> mask;
+			for (const YAML::Node &bit : entry["mask"])
+				mask.push_back(bit.as<int>() != 0);
+			if (mask.size() > size()) resize(mask.size());
+			set(mask, index);
+		}
+	}
+#else
+	(void)node;
+	throw std::runtime_error(NO_YAML_SUPPORT);
+#endif
+}
+
+void TaxelRegions::load(const std::string &sYAMLFile)
+{
+#ifdef HAVE_YAML
+	load(YAML::LoadFile(sYAMLFile));
+#else
+	throw std::runtime_error(NO_YAML_SUPPORT);
+#endif
+}
+
+}  // namespace tactile
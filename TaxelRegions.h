@@ -0,0 +1,97 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace YAML {
+class Node;
+}
+
+namespace tactile {
+
+/* Named, disjoint regions of taxels of an array, e.g. palm, phalanges, and fingertips.
+   Each taxel refers to its region by a compact index (0 = no region).
+   Consecutive taxels of the same region are grouped into runs, such that all regions
+   can be accumulated with a segmented reduction in a single traversal of the array.
+ */
+class TaxelRegions {
+public:
+	using Index = uint16_t;
+	struct Run
+	{
+		size_t begin, end;  // taxel range [begin, end)
+		Index index;
+	};
+
+	TaxelRegions(size_t n = 0) { resize(n); }
+
+	/// number of taxels
+	size_t size() const { return vIndices.size(); }
+	/// resize to n taxels, keeping the region of existing ones
+	void resize(size_t n);
+	/// reserve memory for n taxels, such that resizing up to n taxels
+	/// (and assigning existing regions to them) doesn't allocate
+	void reserve(size_t n);
+	/// remove all regions
+	void clear();
+
+	/// number of regions (including the null region at index 0)
+	size_t numRegions() const { return vNames.size(); }
+	/// name of region with given index
+	const std::string &name(Index index) const { return vNames[index]; }
+	/// index of region with given name (0 if not found)
+	Index find(const std::string &sName) const;
+	/// add region with given name (if not yet present) and return its index
+	Index add(const std::string &sName);
+	/// number of taxels in region with given index
+	size_t count(Index index) const { return vCounts[index]; }
+
+	/// region index of given taxel
+	Index index(size_t taxel) const { return vIndices[taxel]; }
+	/// assign taxels [first, last) to region
+	void set(size_t first, size_t last, Index index);
+	/// assign taxels with given indices to region
+	void set(const std::vector<size_t> &taxels, Index index);
+	/// assign taxels i with mask[i] set to region
+	void set(const std::vector<bool> &mask, Index index);
+
+	/// runs of taxels sharing the same region, covering all taxels
+	const std::vector<Run> &runs() const { return vRuns; }
+
+	/// load regions from YAML file
+	void load(const std::string &sYAMLFile);
+	void load(const YAML::Node &node);
+
+private:
+	void update();
+
+	std::vector<std::string> vNames;  // region names, [0] = ""
+	std::vector<Index> vIndices;      // region index per taxel
+	std::vector<size_t> vCounts;      // number of taxels per region
+	std::vector<Run> vRuns;           // runs of taxels
+};
+
+}  // namespace tactile
@@ -0,0 +1,98 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "ThreadPool.h"
+#include <errno.h>
+#include <algorithm>
+
+namespace tactile {
+
+// wait for semaphore, retrying when interrupted by a signal
+static void wait(sem_t *sem)
+{
+	while (sem_wait(sem) != 0 && errno == EINTR)
+		;
+}
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+	if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+	start.reset(new sem_t[numThreads]);
+	sem_init(&done, 0, 0);
+	for (size_t thread = 1; thread < numThreads; ++thread) {
+		sem_init(&start[thread], 0, 0);
+		workers.emplace_back(&ThreadPool::work, this, thread);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	bStop = true;
+	for (size_t thread = 1; thread < size(); ++thread)
+		sem_post(&start[thread]);
+	for (auto &worker : workers)
+		worker.join();
+	for (size_t thread = 1; thread < size(); ++thread)
+		sem_destroy(&start[thread]);
+	sem_destroy(&done);
+}
+
+void ThreadPool::run(Task fn, void *context)
+{
+	// semaphores provide the memory ordering of task (and bStop) w.r.t. the workers
+	task = fn;
+	this->context = context;
+	error = nullptr;
+	for (size_t thread = 1; thread < size(); ++thread)
+		sem_post(&start[thread]);
+
+	std::exception_ptr local;
+	try {
+		fn(context, 0);
+	} catch (...) {
+		local = std::current_exception();
+	}
+
+	for (size_t thread = 1; thread < size(); ++thread)
+		wait(&done);
+	task = nullptr;
+	this->context = nullptr;
+	if (!local) local = error;
+	if (local) std::rethrow_exception(local);
+}
+
+void ThreadPool::work(size_t thread)
+{
+	while (true) {
+		wait(&start[thread]);
+		if (bStop) return;
+		try {
+			task(context, thread);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!error) error = std::current_exception();
+		}
+		sem_post(&done);
+	}
+}
+
+}  // namespace tactile
@@ -0,0 +1,80 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include <semaphore.h>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tactile {
+
+/* Persistent pool of worker threads executing a function on all threads in parallel.
+   The calling thread participates as thread 0, such that a pool of size 1 runs serially.
+   Workers are woken and joined via POSIX semaphores, which are cheap to post and do not
+   require the caller to hold a lock.
+ */
+class ThreadPool {
+public:
+	/// create pool of given size (including the calling thread), 0 = hardware concurrency
+	explicit ThreadPool(size_t numThreads = 0);
+	~ThreadPool();
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	/// number of threads (including the calling thread)
+	size_t size() const { return workers.size() + 1; }
+
+	/// task function, called as fn(context, thread)
+	using Task = void (*)(void *context, size_t thread);
+
+	/// call fn(context, thread) for all threads in [0, size()) in parallel,
+	/// returning when all are done. An exception thrown by any of the calls is rethrown.
+	void run(Task fn, void *context);
+	/// call fn(thread) for all threads in parallel
+	/// The callable is passed by reference, such that no (allocating) type erasure is needed.
+	template <typename Function>
+	void run(const Function &fn)
+	{
+		run([](void *context, size_t thread) {
+			    (*static_cast<const Function *>(context))(thread);
+		    },
+		    const_cast<Function *>(&fn));
+	}
+
+private:
+	void work(size_t thread);
+
+	std::vector<std::thread> workers;
+	std::unique_ptr<sem_t[]> start;  // per-worker semaphore signaling a new task
+	sem_t done;                      // posted by each worker when finished with a task
+	Task task = nullptr;
+	void *context = nullptr;
+	bool bStop = false;
+	std::mutex mutex;  // protects error
+	std::exception_ptr error;
+};
+
+}  // namespace tactile
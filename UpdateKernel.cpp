@@ -0,0 +1,249 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "UpdateKernel.h"
+#include "TactileValue.h"
+#include <atomic>
+#include <float.h>
+#include <math.h>
+
+namespace tactile {
+
+// instruction-set specific variants, compiled in separate translation units
+#ifdef HAVE_SSE4
+void updateSSE4(const TactileState &s, const TactileParams &p, const float *in, size_t n);
+void updateFramesSSE4(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                      size_t nFrames, size_t stride);
+#endif
+#ifdef HAVE_AVX2
+void updateAVX2(const TactileState &s, const TactileParams &p, const float *in, size_t n);
+void updateFramesAVX2(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                      size_t nFrames, size_t stride);
+#endif
+#ifdef HAVE_NEON
+void updateNEON(const TactileState &s, const TactileParams &p, const float *in, size_t n);
+void updateFramesNEON(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                      size_t nFrames, size_t stride);
+#endif
+
+// single filter step of taxel i, equivalent to TactileValue::update()
+static inline void updateTaxel(const TactileState &s, const TactileParams &p, size_t i,
+                               float fNew)
+{
+	if (fNew < s.absMin[i]) s.absMin[i] = fNew;
+	if (fNew > s.absMax[i]) s.absMax[i] = fNew;
+	float fMin = fNew < s.dynMin[i] ? fNew : s.dynMin[i];
+	float fMax = fNew > s.dynMax[i] ? fNew : s.dynMax[i];
+	s.dynMin[i] = fMin = fNew - p.rangeLambda * (fNew - fMin);
+	s.dynMax[i] = fMax = fNew + p.rangeLambda * (fMax - fNew);
+
+	const float fCur = s.cur[i];
+	if (isnan(fCur)) {  // first update: init vars and return
+		s.cur[i] = s.mean[i] = fNew;
+		return;
+	}
+	s.mean[i] = fNew + p.meanLambda * (s.mean[i] - fNew);
+
+	const float fMargin = 0.1 * (s.absMax[i] - s.absMin[i]);
+	float fReleased = s.released[i];
+	if (fReleased != FLT_MAX && fNew > fCur + fMargin) {
+		fReleased = FLT_MAX;  // leave release mode
+	} else if (fReleased == FLT_MAX && fNew < fCur - fMargin) {
+		fReleased = fCur;  // enter release mode
+	} else if (fReleased != FLT_MAX) {
+		fReleased -= p.releaseDecay * (fMax - fMin);
+		if (fReleased < fMin) fReleased = FLT_MAX;
+	}
+	s.released[i] = fReleased;
+	s.cur[i] = fNew;
+}
+
+void updateScalar(const TactileState &s, const TactileParams &p, const float *in, size_t begin,
+                  size_t end)
+{
+	for (size_t i = begin; i < end; ++i) {
+		if (isfinite(in[i])) updateTaxel(s, p, i, in[i]);
+	}
+}
+
+static void updateScalar(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	updateScalar(s, p, in, 0, n);
+}
+
+void updateFramesScalar(const TactileState &s, const TactileParams &p, const float *in,
+                        size_t begin, size_t end, size_t nFrames, size_t stride)
+{
+	for (size_t i = begin; i < end; ++i) {
+		const float *x = in + i;
+		for (size_t f = 0; f < nFrames; ++f, x += stride) {
+			if (isfinite(*x)) updateTaxel(s, p, i, *x);
+		}
+	}
+}
+
+static void updateFramesScalar(const TactileState &s, const TactileParams &p, const float *in,
+                               size_t n, size_t nFrames, size_t stride)
+{
+	updateFramesScalar(s, p, in, 0, n, nFrames, stride);
+}
+
+using UpdateFunction = void (*)(const TactileState &, const TactileParams &, const float *,
+                                size_t);
+static const UpdateFunction FUNCTIONS[UpdateKernel::NUM_ISAS] = {
+	updateScalar,
+#ifdef HAVE_SSE4
+	updateSSE4,
+#else
+	nullptr,
+#endif
+#ifdef HAVE_AVX2
+	updateAVX2,
+#else
+	nullptr,
+#endif
+#ifdef HAVE_NEON
+	updateNEON,
+#else
+	nullptr,
+#endif
+};
+
+using UpdateFramesFunction = void (*)(const TactileState &, const TactileParams &, const float *,
+                                      size_t, size_t, size_t);
+static const UpdateFramesFunction FRAMES_FUNCTIONS[UpdateKernel::NUM_ISAS] = {
+	updateFramesScalar,
+#ifdef HAVE_SSE4
+	updateFramesSSE4,
+#else
+	nullptr,
+#endif
+#ifdef HAVE_AVX2
+	updateFramesAVX2,
+#else
+	nullptr,
+#endif
+#ifdef HAVE_NEON
+	updateFramesNEON,
+#else
+	nullptr,
+#endif
+};
+
+// resolve best variant on first use
+static void resolve(const TactileState &s, const TactileParams &p, const float *in, size_t n);
+static void resolveFrames(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                          size_t nFrames, size_t stride);
+static std::atomic<UpdateFunction> FUNCTION(resolve);
+static std::atomic<UpdateFramesFunction> FRAMES_FUNCTION(resolveFrames);
+static std::atomic<UpdateKernel::Isa> SELECTED(UpdateKernel::SCALAR);
+
+static void resolve(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	UpdateKernel::select(UpdateKernel::best());
+	FUNCTION.load(std::memory_order_relaxed)(s, p, in, n);
+}
+
+static void resolveFrames(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                          size_t nFrames, size_t stride)
+{
+	UpdateKernel::select(UpdateKernel::best());
+	FRAMES_FUNCTION.load(std::memory_order_relaxed)(s, p, in, n, nFrames, stride);
+}
+
+void UpdateKernel::update(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	FUNCTION.load(std::memory_order_relaxed)(s, p, in, n);
+}
+
+void UpdateKernel::updateFrames(const TactileState &s, const TactileParams &p, const float *in,
+                                size_t n, size_t nFrames, size_t stride)
+{
+	FRAMES_FUNCTION.load(std::memory_order_relaxed)(s, p, in, n, nFrames, stride);
+}
+
+void UpdateKernel::updateIndexed(const TactileState &s, const TactileParams &p, const float *in,
+                                 const uint32_t *indices, size_t count)
+{
+	// scattered taxels don't benefit from vectorization
+	for (size_t k = 0; k < count; ++k) {
+		const uint32_t i = indices[k];
+		if (isfinite(in[i])) updateTaxel(s, p, i, in[i]);
+	}
+}
+
+void UpdateKernel::updateRepeated(const TactileState &s, const TactileParams &p, size_t i, float x,
+                                  unsigned int nFrames)
+{
+	if (nFrames == 0 || !isfinite(x)) return;
+	updateTaxel(s, p, i, x);
+	if (nFrames > 1)
+		TactileValue::decay(x, nFrames - 1, p.meanLambda, p.rangeLambda, p.releaseDecay, s.mean[i],
+		                    s.dynMin[i], s.dynMax[i], s.released[i]);
+}
+
+bool UpdateKernel::supported(Isa isa)
+{
+	if (isa < SCALAR || isa >= NUM_ISAS || !FUNCTIONS[isa]) return false;
+#if defined(__x86_64__) || defined(__i386__)
+	if (isa == SSE4) return __builtin_cpu_supports("sse4.1");
+	if (isa == AVX2) return __builtin_cpu_supports("avx2");
+#endif
+	return true;
+}
+
+UpdateKernel::Isa UpdateKernel::best()
+{
+	for (int isa = NUM_ISAS - 1; isa > SCALAR; --isa) {
+		if (supported(static_cast<Isa>(isa))) return static_cast<Isa>(isa);
+	}
+	return SCALAR;
+}
+
+UpdateKernel::Isa UpdateKernel::selected()
+{
+	if (FUNCTION.load(std::memory_order_relaxed) == resolve) select(best());
+	return SELECTED.load(std::memory_order_relaxed);
+}
+
+bool UpdateKernel::select(Isa isa)
+{
+	if (!supported(isa)) return false;
+	SELECTED.store(isa, std::memory_order_relaxed);
+	FUNCTION.store(FUNCTIONS[isa], std::memory_order_relaxed);
+	FRAMES_FUNCTION.store(FRAMES_FUNCTIONS[isa], std::memory_order_relaxed);
+	return true;
+}
+
+std::string UpdateKernel::getIsaName(Isa isa)
+{
+	switch (isa) {
+		case SCALAR: return "scalar";
+		case SSE4: return "SSE4.1";
+		case AVX2: return "AVX2";
+		case NEON: return "NEON";
+		default: return "";
+	}
+}
+
+}  // namespace tactile
@@ -0,0 +1,85 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "TactileState.h"
+
+namespace tactile {
+
+/* Batch version of TactileValue::update() operating on struct-of-arrays state.
+   The range tracking, mean filtering, and the release state machine are computed
+   branch-free (using masks) for several taxels at once. Vectorized variants for
+   AVX2 (8 taxels), SSE4.1 (4 taxels), and NEON (4 taxels) are selected at runtime
+   depending on the capabilities of the CPU, falling back to a scalar implementation.
+
+   All variants produce bit-identical results to TactileValue::update(), provided the
+   library is compiled without floating-point contraction (-ffp-contract=off, which is
+   the default in our CMake config). Otherwise, FMA contraction in the scalar code
+   might cause deviations in the order of 1 ulp per filter step.
+   Input values are expected to be calibrated already; non-finite inputs are ignored.
+ */
+class UpdateKernel {
+public:
+	enum Isa
+	{
+		SCALAR = 0,
+		SSE4,
+		AVX2,
+		NEON,
+		NUM_ISAS
+	};
+
+	/// filter taxels of state s with values in[0, n) and parameters p, using the currently
+	/// selected variant
+	static void update(const TactileState &s, const TactileParams &p, const float *in, size_t n);
+	/// filter taxels of state s with nFrames consecutive frames in[f * stride + (0, n)],
+	/// equivalent to nFrames calls of update(), but keeping the state in registers across frames
+	static void updateFrames(const TactileState &s, const TactileParams &p, const float *in,
+	                         size_t n, size_t nFrames, size_t stride);
+
+	/// filter taxels indices[0, count) of state s with values in[indices[k]], e.g. a sparse subset
+	static void updateIndexed(const TactileState &s, const TactileParams &p, const float *in,
+	                          const uint32_t *indices, size_t count);
+
+	/// filter taxel i of state s with nFrames repetitions of value x, computing the decay of
+	/// all but the first step in closed form (see TactileValue::update(float, unsigned int))
+	static void updateRepeated(const TactileState &s, const TactileParams &p, size_t i, float x,
+	                           unsigned int nFrames);
+
+	/// best instruction set supported by the running CPU
+	static Isa best();
+	/// is given instruction set compiled in and supported by the running CPU?
+	static bool supported(Isa isa);
+	/// currently selected instruction set
+	static Isa selected();
+	/// select given instruction set (if supported), returns success
+	static bool select(Isa isa);
+
+	static std::string getIsaName(Isa isa);
+};
+
+}  // namespace tactile
@@ -0,0 +1,154 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#pragma once
+
+// Generic implementation of the vectorized filter kernel, parameterized on a SIMD traits class.
+// This file is included by the instruction-set specific translation units only. To avoid
+// ODR violations between those (compiled with different flags), all code is kept in an
+// anonymous namespace and doesn't rely on inline functions from other headers.
+
+#include "TactileState.h"
+#include <float.h>
+#include <math.h>
+
+namespace tactile {
+
+// scalar filter steps for taxels [begin, end), defined in UpdateKernel.cpp
+void updateScalar(const TactileState &s, const TactileParams &p, const float *in, size_t begin,
+                  size_t end);
+void updateFramesScalar(const TactileState &s, const TactileParams &p, const float *in,
+                        size_t begin, size_t end, size_t nFrames, size_t stride);
+
+namespace {
+
+// filter state of V::WIDTH taxels, kept in registers
+template <class V>
+struct Taxels
+{
+	using F = typename V::F;
+	F absMin, absMax, dynMin, dynMax, cur, mean, released;
+	const F meanLambda, rangeLambda, releaseDecay;  // shared parameters, broadcast
+
+	explicit Taxels(const TactileParams &p)
+	  : meanLambda(V::set1(p.meanLambda))
+	  , rangeLambda(V::set1(p.rangeLambda))
+	  , releaseDecay(V::set1(p.releaseDecay))
+	{}
+
+	void load(const TactileState &s, size_t i)
+	{
+		absMin = V::load(s.absMin + i);
+		absMax = V::load(s.absMax + i);
+		dynMin = V::load(s.dynMin + i);
+		dynMax = V::load(s.dynMax + i);
+		cur = V::load(s.cur + i);
+		mean = V::load(s.mean + i);
+		released = V::load(s.released + i);
+	}
+	void store(const TactileState &s, size_t i) const
+	{
+		V::store(s.absMin + i, absMin);
+		V::store(s.absMax + i, absMax);
+		V::store(s.dynMin + i, dynMin);
+		V::store(s.dynMax + i, dynMax);
+		V::store(s.mean + i, mean);
+		V::store(s.released + i, released);
+		V::store(s.cur + i, cur);
+	}
+
+	// single filter step with new values x
+	void update(F x)
+	{
+		using M = typename V::M;
+		const F none = V::set1(FLT_MAX);  // value of released indicating "not in release mode"
+		const M valid = V::isfinite(x);
+
+		// all-time and sliding minimum + maximum
+		absMin = V::select(V::land(valid, V::lt(x, absMin)), x, absMin);
+		absMax = V::select(V::land(valid, V::gt(x, absMax)), x, absMax);
+		const F newMin =
+		    V::sub(x, V::mul(rangeLambda, V::sub(x, V::select(V::lt(x, dynMin), x, dynMin))));
+		const F newMax =
+		    V::add(x, V::mul(rangeLambda, V::sub(V::select(V::gt(x, dynMax), x, dynMax), x)));
+
+		// first valid value initializes cur + mean, later ones update them
+		const M first = V::neq(cur, cur);
+		const M update = V::landnot(valid, first);
+		const F newMean = V::add(x, V::mul(meanLambda, V::sub(mean, x)));
+
+		// masked release state machine
+		const F margin = V::margin(V::sub(absMax, absMin));
+		const M inRelease = V::neq(released, none);
+		const M leave = V::gt(x, V::add(cur, margin));
+		const M enter = V::lt(x, V::sub(cur, margin));
+		F decayed = V::sub(released, V::mul(releaseDecay, V::sub(newMax, newMin)));
+		decayed = V::select(V::lt(decayed, newMin), none, decayed);
+		const F newReleased =
+		    V::select(inRelease, V::select(leave, none, decayed), V::select(enter, cur, released));
+
+		dynMin = V::select(valid, newMin, dynMin);
+		dynMax = V::select(valid, newMax, dynMax);
+		mean = V::select(update, newMean, V::select(valid, x, mean));
+		released = V::select(update, newReleased, released);
+		cur = V::select(valid, x, cur);
+	}
+};
+
+template <class V>
+void updateVectorized(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	Taxels<V> t(p);
+	size_t i = 0;
+	for (; i + V::WIDTH <= n; i += V::WIDTH) {
+		t.load(s, i);
+		t.update(V::load(in + i));
+		t.store(s, i);
+	}
+	updateScalar(s, p, in, i, n);  // remaining taxels
+}
+
+// taxel-major processing of nFrames frames, keeping the state in registers across frames
+// Frames are processed in tiles of FRAME_TILE frames to keep the input of all taxels in cache.
+template <class V>
+void updateFramesVectorized(const TactileState &s, const TactileParams &p, const float *in,
+                            size_t n, size_t nFrames, size_t stride)
+{
+	const size_t FRAME_TILE = 16;
+	Taxels<V> t(p);
+	for (size_t tile = 0; tile < nFrames; tile += FRAME_TILE, in += FRAME_TILE * stride) {
+		const size_t frames = nFrames - tile < FRAME_TILE ? nFrames - tile : FRAME_TILE;
+		size_t i = 0;
+		for (; i + V::WIDTH <= n; i += V::WIDTH) {
+			t.load(s, i);
+			const float *x = in + i;
+			for (size_t f = 0; f < frames; ++f, x += stride)
+				t.update(V::load(x));
+			t.store(s, i);
+		}
+		updateFramesScalar(s, p, in, i, n, frames, stride);  // remaining taxels
+	}
+}
+
+}  // namespace
+}  // namespace tactile
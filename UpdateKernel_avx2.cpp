@@ -0,0 +1,82 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+// compiled with -mavx2
+#include "UpdateKernelImpl.h"
+#include <immintrin.h>
+
+namespace tactile {
+namespace {
+
+struct AVX2
+{
+	using F = __m256;
+	using M = __m256;
+	enum
+	{
+		WIDTH = 8
+	};
+
+	static F load(const float *p) { return _mm256_loadu_ps(p); }
+	static void store(float *p, F v) { _mm256_storeu_ps(p, v); }
+	static F set1(float v) { return _mm256_set1_ps(v); }
+	static F add(F a, F b) { return _mm256_add_ps(a, b); }
+	static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+	static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+	static M lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static M gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static M neq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }  // true for NaN
+	static M land(M a, M b) { return _mm256_and_ps(a, b); }
+	static M landnot(M a, M b) { return _mm256_andnot_ps(b, a); }  // a & ~b
+	static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+	static M isfinite(F x)
+	{
+		const F abs = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+		return _mm256_cmp_ps(abs, _mm256_set1_ps(INFINITY), _CMP_LT_OQ);
+	}
+	// float(0.1 * double(r)), computed in double precision as the scalar code does
+	static F margin(F r)
+	{
+		const __m256d scale = _mm256_set1_pd(0.1);
+		const __m128 lo =
+		    _mm256_cvtpd_ps(_mm256_mul_pd(scale, _mm256_cvtps_pd(_mm256_castps256_ps128(r))));
+		const __m128 hi =
+		    _mm256_cvtpd_ps(_mm256_mul_pd(scale, _mm256_cvtps_pd(_mm256_extractf128_ps(r, 1))));
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+	}
+};
+
+}  // namespace
+
+void updateAVX2(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	updateVectorized<AVX2>(s, p, in, n);
+}
+
+void updateFramesAVX2(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                      size_t nFrames, size_t stride)
+{
+	updateFramesVectorized<AVX2>(s, p, in, n, nFrames, stride);
+}
+
+}  // namespace tactile
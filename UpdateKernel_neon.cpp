@@ -0,0 +1,74 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+// AArch64 only: requires double-precision vector instructions
+#include "UpdateKernelImpl.h"
+#include <arm_neon.h>
+
+namespace tactile {
+namespace {
+
+struct NEON
+{
+	using F = float32x4_t;
+	using M = uint32x4_t;
+	enum
+	{
+		WIDTH = 4
+	};
+
+	static F load(const float *p) { return vld1q_f32(p); }
+	static void store(float *p, F v) { vst1q_f32(p, v); }
+	static F set1(float v) { return vdupq_n_f32(v); }
+	static F add(F a, F b) { return vaddq_f32(a, b); }
+	static F sub(F a, F b) { return vsubq_f32(a, b); }
+	static F mul(F a, F b) { return vmulq_f32(a, b); }
+	static M lt(F a, F b) { return vcltq_f32(a, b); }
+	static M gt(F a, F b) { return vcgtq_f32(a, b); }
+	static M neq(F a, F b) { return vmvnq_u32(vceqq_f32(a, b)); }  // true for NaN
+	static M land(M a, M b) { return vandq_u32(a, b); }
+	static M landnot(M a, M b) { return vbicq_u32(a, b); }  // a & ~b
+	static F select(M m, F a, F b) { return vbslq_f32(m, a, b); }
+	static M isfinite(F x) { return vcltq_f32(vabsq_f32(x), vdupq_n_f32(INFINITY)); }
+	// float(0.1 * double(r)), computed in double precision as the scalar code does
+	static F margin(F r)
+	{
+		const float32x2_t lo = vcvt_f32_f64(vmulq_n_f64(vcvt_f64_f32(vget_low_f32(r)), 0.1));
+		return vcvt_high_f32_f64(lo, vmulq_n_f64(vcvt_high_f64_f32(r), 0.1));
+	}
+};
+
+}  // namespace
+
+void updateNEON(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	updateVectorized<NEON>(s, p, in, n);
+}
+
+void updateFramesNEON(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                      size_t nFrames, size_t stride)
+{
+	updateFramesVectorized<NEON>(s, p, in, n, nFrames, stride);
+}
+
+}  // namespace tactile
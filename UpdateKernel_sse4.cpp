@@ -0,0 +1,80 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+// compiled with -msse4.1
+#include "UpdateKernelImpl.h"
+#include <smmintrin.h>
+
+namespace tactile {
+namespace {
+
+struct SSE4
+{
+	using F = __m128;
+	using M = __m128;
+	enum
+	{
+		WIDTH = 4
+	};
+
+	static F load(const float *p) { return _mm_loadu_ps(p); }
+	static void store(float *p, F v) { _mm_storeu_ps(p, v); }
+	static F set1(float v) { return _mm_set1_ps(v); }
+	static F add(F a, F b) { return _mm_add_ps(a, b); }
+	static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+	static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+	static M lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+	static M gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+	static M neq(F a, F b) { return _mm_cmpneq_ps(a, b); }  // true for NaN
+	static M land(M a, M b) { return _mm_and_ps(a, b); }
+	static M landnot(M a, M b) { return _mm_andnot_ps(b, a); }  // a & ~b
+	static F select(M m, F a, F b) { return _mm_blendv_ps(b, a, m); }
+	static M isfinite(F x)
+	{
+		const F abs = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+		return _mm_cmplt_ps(abs, _mm_set1_ps(INFINITY));
+	}
+	// float(0.1 * double(r)), computed in double precision as the scalar code does
+	static F margin(F r)
+	{
+		const __m128d scale = _mm_set1_pd(0.1);
+		const __m128 lo = _mm_cvtpd_ps(_mm_mul_pd(scale, _mm_cvtps_pd(r)));
+		const __m128 hi = _mm_cvtpd_ps(_mm_mul_pd(scale, _mm_cvtps_pd(_mm_movehl_ps(r, r))));
+		return _mm_movelh_ps(lo, hi);
+	}
+};
+
+}  // namespace
+
+void updateSSE4(const TactileState &s, const TactileParams &p, const float *in, size_t n)
+{
+	updateVectorized<SSE4>(s, p, in, n);
+}
+
+void updateFramesSSE4(const TactileState &s, const TactileParams &p, const float *in, size_t n,
+                      size_t nFrames, size_t stride)
+{
+	updateFramesVectorized<SSE4>(s, p, in, n, nFrames, stride);
+}
+
+}  // namespace tactile
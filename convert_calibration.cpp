@@ -0,0 +1,51 @@
+/* ============================================================
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+#include "CalibrationFile.h"
+#include <iostream>
+
+using namespace tactile;
+
+/* Convert YAML calibration files into a single binary CalibrationFile.
+   Curves are named by the basename of their YAML file (without extension).
+ */
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		std::cerr << "usage: " << argv[0] << " output.bin input.yaml [input.yaml ...]" << std::endl;
+		return 1;
+	}
+	try {
+		std::vector<CalibrationFile::NamedCurve> curves;
+		for (int i = 2; i < argc; ++i) {
+			std::string name = argv[i];
+			name = name.substr(name.find_last_of('/') + 1);
+			name = name.substr(0, name.find_last_of('.'));
+			curves.emplace_back(name, PieceWiseLinearCalib::load(std::string(argv[i])));
+		}
+		CalibrationFile::save(argv[1], curves);
+	} catch (const std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
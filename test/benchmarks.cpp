@@ -0,0 +1,354 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+
+#include <benchmark/benchmark.h>
+#include "TactileValueArray.h"
+#include "PieceWiseLinearCalib.h"
+#include "TactileSkin.h"
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+
+using namespace tactile;
+
+static const int MIN_TAXELS = 16;
+static const int MAX_TAXELS = 16 << 10;
+
+// pseudo-random, reproducible frame of raw sensor codes
+template <typename T>
+static std::vector<T> frame(size_t n, int seed = 0)
+{
+	std::vector<T> result(n);
+	for (size_t i = 0; i < n; ++i)
+		result[i] = T((i * 7919 + seed * 104729) % 4096);
+	return result;
+}
+
+static std::shared_ptr<PieceWiseLinearCalib> calibration(size_t knots)
+{
+	PieceWiseLinearCalib::CalibrationMap m;
+	for (size_t k = 0; k < knots; ++k)
+		m[4095.f * k / (knots - 1)] = sqrtf(float(k));
+	return std::make_shared<PieceWiseLinearCalib>(m);
+}
+
+static void TactileValue_update(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	std::vector<TactileValue> taxels(n);
+	if (state.range(1)) {
+		auto c = calibration(16);
+		for (auto &t : taxels)
+			t.setCalibration(c);
+	}
+	const auto input = frame<float>(n);
+	for (auto _ : state) {
+		for (size_t i = 0; i < n; ++i)
+			taxels[i].update(input[i]);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValue_update)
+    ->ArgNames({ "taxels", "calib" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 } });
+
+template <typename T>
+static void TactileValueArray_updateValues(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	TactileValueArray array(n);
+	if (state.range(1)) array.calibrations().set(0, n, array.calibrations().add(calibration(16)));
+	const auto input = frame<T>(n);
+	for (auto _ : state) {
+		array.updateValues(input);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(TactileValueArray_updateValues, float)
+    ->ArgNames({ "taxels", "calib" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 } });
+BENCHMARK_TEMPLATE(TactileValueArray_updateValues, uint16_t)
+    ->ArgNames({ "taxels", "calib" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 } });
+
+// frames with 1% of taxels changing, processed densely or sparsely (with a deadband)
+static void TactileValueArray_updateValues_sparse(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	TactileValueArray array(n);
+	if (state.range(1)) array.setDeadband(0.5);
+	std::vector<float> input(n, 0.f);
+	array.updateValues(input);
+	size_t k = 0;
+	for (auto _ : state) {
+		for (size_t i = k % 100; i < n; i += 100)
+			input[i] += 1.f;
+		++k;
+		array.updateValues(input);
+		array.clearActive();
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_updateValues_sparse)
+    ->ArgNames({ "taxels", "sparse" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 } });
+
+// frames with jittered timestamps, deriving lambdas from time constants, or with fixed lambdas
+static void TactileValueArray_updateValuesAt(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	TactileValueArray array(n);
+	const auto input = frame<float>(n);
+	double t = 0.0;
+	size_t k = 0;
+	for (auto _ : state) {
+		t += 0.001 * (1 + 0.1 * (k++ % 3));
+		if (state.range(1))
+			array.updateValuesAt(input, t);
+		else
+			array.updateValues(input);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_updateValuesAt)
+    ->ArgNames({ "taxels", "timed" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 } });
+
+// array interleaved with another one in a packet: consumed in place or de-interleaved first
+static void TactileValueArray_updateValues_strided(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	TactileValueArray array(n);
+	const auto packet = frame<uint16_t>(2 * n);
+	std::vector<uint16_t> codes(n);
+	for (auto _ : state) {
+		if (state.range(1)) {
+			array.updateValues(StridedView<uint16_t>(packet.data(), 2 * sizeof(uint16_t), n));
+		} else {
+			for (size_t i = 0; i < n; ++i)
+				codes[i] = packet[2 * i];
+			array.updateValues(codes);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_updateValues_strided)
+    ->ArgNames({ "taxels", "view" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 } });
+
+// block of 64 frames, processed at once or frame by frame (items = taxel updates)
+static void TactileValueArray_updateFrames(benchmark::State &state)
+{
+	const size_t n = state.range(0), frames = 64;
+	TactileValueArray array(n);
+	if (state.range(1)) array.calibrations().set(0, n, array.calibrations().add(calibration(16)));
+	std::vector<float> input;
+	for (size_t f = 0; f < frames; ++f) {
+		const auto values = frame<float>(n, f);
+		input.insert(input.end(), values.begin(), values.end());
+	}
+	for (auto _ : state) {
+		if (state.range(2)) {
+			array.updateFrames(input.data(), frames, n);
+		} else {
+			for (size_t f = 0; f < frames; ++f)
+				array.updateValues(input.begin() + f * n, input.begin() + (f + 1) * n);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * n * frames);
+}
+BENCHMARK(TactileValueArray_updateFrames)
+    ->ArgNames({ "taxels", "calib", "batch" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4), { 0, 1 }, { 0, 1 } });
+
+// array with some history, such that all modes yield non-trivial values
+static void prepare(TactileValueArray &array, size_t n)
+{
+	array.init(n);
+	for (int k = 0; k < 10; ++k)
+		array.updateValues(frame<float>(n, k));
+}
+
+static void TactileValueArray_getValues(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	const auto mode = TactileValue::Mode(state.range(1));
+	TactileValueArray array;
+	prepare(array, n);
+	TactileValueArray::vector_data output(n);
+	for (auto _ : state) {
+		array.getValues(mode, output);
+		benchmark::DoNotOptimize(output.data());
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+	state.SetLabel(TactileValue::getModeName(mode));
+}
+BENCHMARK(TactileValueArray_getValues)
+    ->ArgNames({ "taxels", "mode" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4),
+                    benchmark::CreateDenseRange(0, TactileValue::lastMode, 1) });
+
+static void TactileValueArray_accumulate_data(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	const auto mode = TactileValueArray::AccMode(state.range(1));
+	TactileValueArray array;
+	prepare(array, n);
+	const auto data = array.getValues(TactileValue::dynCurrentRelease);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(TactileValueArray::accumulate(data, mode));
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_accumulate_data)
+    ->ArgNames({ "taxels", "acc" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4),
+                    benchmark::CreateDenseRange(0, TactileValueArray::lastMode - 1, 1) });
+
+static void TactileValueArray_accumulate_mode(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	const auto mode = TactileValueArray::AccMode(state.range(1));
+	TactileValueArray array;
+	prepare(array, n);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(array.accumulate(TactileValue::dynCurrentRelease, mode));
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_accumulate_mode)
+    ->ArgNames({ "taxels", "acc" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4),
+                    benchmark::CreateDenseRange(0, TactileValueArray::lastMode - 1, 1) });
+
+static void TactileValueArray_accumulate_accessor(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	const auto mode = TactileValueArray::AccMode(state.range(1));
+	TactileValueArray array;
+	prepare(array, n);
+	const TactileValueArray::AccessorFunction accessor =
+	    [](const TactileValueArray::ConstReference &taxel) {
+		    return taxel.value(TactileValue::dynCurrentRelease);
+	    };
+	for (auto _ : state)
+		benchmark::DoNotOptimize(array.accumulate(accessor, mode));
+	state.SetItemsProcessed(state.iterations() * n);
+	state.SetLabel(TactileValueArray::getModeName(mode));
+}
+BENCHMARK(TactileValueArray_accumulate_accessor)
+    ->ArgNames({ "taxels", "acc" })
+    ->ArgsProduct({ benchmark::CreateRange(MIN_TAXELS, MAX_TAXELS, 4),
+                    benchmark::CreateDenseRange(0, TactileValueArray::lastMode - 1, 1) });
+
+static void TactileValueArray_accumulateAll(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	TactileValueArray array;
+	prepare(array, n);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(array.accumulateAll(TactileValue::dynMean));
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_accumulateAll)
+    ->ArgName("taxels")
+    ->Range(MIN_TAXELS, MAX_TAXELS)
+    ->RangeMultiplier(4);
+
+static void TactileValueArray_histogram(benchmark::State &state)
+{
+	const size_t n = state.range(0);
+	TactileValueArray array;
+	prepare(array, n);
+	std::vector<size_t> bins(32);
+	for (auto _ : state) {
+		array.histogram(TactileValue::dynMean, 0, 1, bins);
+		benchmark::DoNotOptimize(bins.data());
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(TactileValueArray_histogram)
+    ->ArgName("taxels")
+    ->Range(MIN_TAXELS, MAX_TAXELS)
+    ->RangeMultiplier(4);
+
+// skin of 40 arrays with 512 taxels each (20k taxels), processed by given number of threads
+static void TactileSkin_update(benchmark::State &state)
+{
+	TactileSkin skin(state.range(0));
+	for (int i = 0; i < 40; ++i)
+		skin.add(512);
+	const auto codes = frame<uint16_t>(skin.numTaxels());
+	std::vector<float> values(skin.numTaxels());
+	for (auto _ : state) {
+		skin.updateValues(codes);
+		skin.getValues(TactileValue::dynMean, values.data());
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * skin.numTaxels());
+}
+BENCHMARK(TactileSkin_update)->ArgName("threads")->DenseRange(1, 4)->UseRealTime();
+
+static void PieceWiseLinearCalib_map(benchmark::State &state)
+{
+	const size_t n = 1024;
+	const auto c = calibration(state.range(0));
+	std::vector<float> input = frame<float>(n), output(n);
+	for (auto _ : state) {
+		if (state.range(1)) {
+			c->map(input.data(), output.data(), n);
+		} else {
+			for (size_t i = 0; i < n; ++i)
+				output[i] = c->map(input[i]);
+		}
+		benchmark::DoNotOptimize(output.data());
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(PieceWiseLinearCalib_map)
+    ->ArgNames({ "knots", "batch" })
+    ->ArgsProduct({ { 2, 4, 16, 64, 256, 1000 }, { 0, 1 } });
+// non-uniform knots, requiring binary search
+static void PieceWiseLinearCalib_map_irregular(benchmark::State &state)
+{
+	const size_t n = 1024;
+	PieceWiseLinearCalib::CalibrationMap m;
+	for (int k = 0; k < state.range(0); ++k)
+		m[4095.f * k * k / ((state.range(0) - 1) * (state.range(0) - 1))] = k;
+	const PieceWiseLinearCalib c(m);
+	std::vector<float> input = frame<float>(n), output(n);
+	for (auto _ : state) {
+		c.map(input.data(), output.data(), n);
+		benchmark::DoNotOptimize(output.data());
+	}
+	state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(PieceWiseLinearCalib_map_irregular)->ArgName("knots")->Arg(4)->Arg(16)->Arg(64)->Arg(256)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,149 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "CalibrationBank.h"
+#include "PieceWiseLinearCalib.h"
+#include "TactileValueArray.h"
+#include <math.h>
+
+using namespace tactile;
+
+TEST(CalibrationBank, runs)
+{
+	auto a = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 2 } }));
+	auto b = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, -1 } }));
+	CalibrationBank bank(10);
+	EXPECT_TRUE(bank.empty());
+	bank.set(2, a);
+	bank.set(3, a);
+	bank.set(4, b);
+	bank.set(8, 10, bank.add(a));
+	EXPECT_EQ(bank.numCurves(), 3u);
+	EXPECT_EQ(bank.index(3), bank.index(9));
+	EXPECT_EQ(bank.get(0), nullptr);
+
+	std::vector<std::tuple<size_t, size_t, const Calibration *>> runs;
+	auto collect = [&runs](size_t begin, size_t end, const Calibration *c) {
+		runs.emplace_back(begin, end, c);
+	};
+	bank.forEachRun(0, 10, collect);
+	ASSERT_EQ(runs.size(), 3u);
+	EXPECT_EQ(runs[0], std::make_tuple(size_t(2), size_t(4), (const Calibration *)a.get()));
+	EXPECT_EQ(runs[1], std::make_tuple(size_t(4), size_t(5), (const Calibration *)b.get()));
+	EXPECT_EQ(runs[2], std::make_tuple(size_t(8), size_t(10), (const Calibration *)a.get()));
+
+	// partial range, indices relative to start
+	runs.clear();
+	bank.forEachRun(3, 6, collect);
+	ASSERT_EQ(runs.size(), 3u);
+	EXPECT_EQ(runs[0], std::make_tuple(size_t(0), size_t(1), (const Calibration *)a.get()));
+	EXPECT_EQ(runs[2], std::make_tuple(size_t(5), size_t(6), (const Calibration *)a.get()));
+}
+
+TEST(CalibrationBank, replace)
+{
+	CalibrationBank bank(4);
+	std::weak_ptr<Calibration> first;
+	// replacing calibrations must neither accumulate curves nor exhaust the index space
+	for (size_t i = 0; i < 100000; ++i) {
+		auto c = std::make_shared<PieceWiseLinearCalib>(
+		    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, float(i) } }));
+		if (i == 0) first = c;
+		bank.set(1, c);
+		bank.set(2, 4, bank.add(c));
+		EXPECT_LE(bank.numCurves(), 2u);
+	}
+	EXPECT_TRUE(first.expired());
+	EXPECT_FALSE(bank.empty());
+
+	bank.set(1, 4, 0);
+	EXPECT_TRUE(bank.empty());
+	EXPECT_EQ(bank.numCurves(), 1u);
+
+	// shrinking releases calibrations of removed taxels
+	auto c = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 1 } }));
+	bank.set(3, c);
+	bank.resize(3);
+	EXPECT_EQ(bank.numCurves(), 1u);
+	EXPECT_EQ(c.use_count(), 1);
+}
+
+TEST(CalibrationBank, reserve)
+{
+	auto c = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 1 } }));
+	CalibrationBank bank(10);
+	const auto index = bank.add(c);
+	bank.reserve(100);
+	const auto *runs = bank.runs().data();
+	const size_t capacity = bank.runs().capacity();
+	EXPECT_GE(capacity, 100u);
+
+	bank.resize(100);
+	for (size_t taxel = 0; taxel < 100; taxel += 2)  // one run per taxel
+		bank.set(taxel, taxel + 1, index);
+	EXPECT_EQ(bank.runs().size(), 100u);
+	EXPECT_EQ(bank.runs().data(), runs);
+	EXPECT_EQ(bank.runs().capacity(), capacity);
+}
+
+TEST(CalibrationBank, yaml)
+{
+#ifdef HAVE_YAML
+	TactileValueArray array;
+	array.loadCalibrations("bank.yaml");
+	ASSERT_EQ(array.size(), 8u);
+	EXPECT_EQ(array.calibrations().numCurves(), 3u);
+	array.updateValues(std::vector<float>({ 0.2, 1.5, 2.2, 4, 5, 5, 5, 5 }));
+
+	std::vector<float> expected = { 0.2, 1, 0.8, 0, 5, 0.5, 5, 0.5 };
+	std::vector<float> values = array.getValues(TactileValue::rawCurrent);
+	for (size_t i = 0; i < expected.size(); ++i)
+		EXPECT_FLOAT_EQ(values[i], expected[i]) << i;
+#else
+	CalibrationBank bank;
+	ASSERT_THROW(bank.load("bank.yaml"), std::runtime_error);
+#endif
+}
+
+TEST(CalibrationBank, yaml_overlap)
+{
+#ifdef HAVE_YAML
+	// curve a is replaced on taxels 0-1, but still assigned to taxels 2-3 afterwards
+	CalibrationBank bank;
+	bank.load("bank_overlap.yaml");
+	ASSERT_EQ(bank.size(), 4u);
+	EXPECT_EQ(bank.numCurves(), 3u);  // null, a, b: unused curve is released
+	EXPECT_FLOAT_EQ(bank.get(0)->map(1), -1);
+	EXPECT_FLOAT_EQ(bank.get(1)->map(1), -1);
+	ASSERT_NE(bank.get(2), nullptr);
+	EXPECT_FLOAT_EQ(bank.get(2)->map(1), 2);
+	EXPECT_EQ(bank.index(2), bank.index(3));
+	EXPECT_NE(bank.index(0), bank.index(2));
+#endif
+}
@@ -0,0 +1,93 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "FrameRing.h"
+#include <thread>
+
+using namespace tactile;
+
+TEST(FrameRing, overflow)
+{
+	FrameRing<uint16_t> ring(3, 2);
+	const uint16_t frame[3] = { 1, 2, 3 };
+	EXPECT_EQ(ring.front(), nullptr);
+	EXPECT_TRUE(ring.push(frame));
+	EXPECT_TRUE(ring.push(frame));
+	EXPECT_EQ(ring.size(), 2u);
+	EXPECT_FALSE(ring.push(frame));
+	EXPECT_FALSE(ring.push(frame));
+	EXPECT_EQ(ring.dropped(), 2u);
+	EXPECT_EQ(ring.overflows(), 1u);
+
+	ASSERT_NE(ring.front(), nullptr);
+	EXPECT_EQ(ring.front()[2], 3);
+	ring.pop();
+	EXPECT_TRUE(ring.push(frame));
+	EXPECT_FALSE(ring.push(frame));
+	EXPECT_EQ(ring.dropped(), 3u);
+	EXPECT_EQ(ring.overflows(), 2u);
+
+	TactileValueArray array;
+	EXPECT_EQ(ring.consume(array), 2u);
+	EXPECT_EQ(array.size(), 3u);
+	EXPECT_EQ(array[1].value(TactileValue::rawCurrent), 2);
+	EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(FrameRing, threads)
+{
+	const size_t n = 100, frames = 20000;
+	FrameRing<float> ring(n, 8);
+	TactileValueArray array(n);
+	size_t consumed = 0;
+
+	std::thread producer([&ring]() {
+		std::vector<float> frame(n);
+		for (size_t f = 0; f < frames; ++f) {
+			float *slot;
+			while (!(slot = ring.beginWrite()))
+				std::this_thread::yield();  // retry dropped frame: all frames should arrive
+			for (size_t i = 0; i < n; ++i)
+				slot[i] = f;
+			ring.commitWrite();
+		}
+	});
+	float last = -1;
+	while (consumed < frames) {
+		if (const float *frame = ring.front()) {
+			// frames arrive complete and in order
+			EXPECT_EQ(frame[0], last + 1);
+			EXPECT_EQ(frame[n - 1], frame[0]);
+			last = frame[0];
+			array.updateValues(frame, frame + n);
+			ring.pop();
+			++consumed;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+	EXPECT_EQ(array[0].value(TactileValue::rawCurrent), frames - 1);
+}
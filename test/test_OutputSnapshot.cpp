@@ -0,0 +1,94 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "OutputSnapshot.h"
+#include <atomic>
+#include <thread>
+
+using namespace tactile;
+
+TEST(OutputSnapshot, publish)
+{
+	const size_t n = 20;
+	TactileValueArray array(n);
+	OutputSnapshot snapshot(n, { TactileValue::rawCurrent, TactileValue::absMean });
+	std::vector<float> values(n), expected(n);
+
+	EXPECT_EQ(snapshot.read(TactileValue::rawCurrent, values.data()), 0u);
+	EXPECT_TRUE(isnan(values[0]));
+	EXPECT_THROW(snapshot.read(TactileValue::dynMean, values.data()), std::invalid_argument);
+
+	// two different frames to establish a non-empty range
+	std::vector<float> frame(n);
+	for (int k = 1; k <= 2; ++k) {
+		for (size_t i = 0; i < n; ++i)
+			frame[i] = k * (i + 1);
+		array.updateValues(frame.begin(), frame.end());
+	}
+	snapshot.publish(array);
+	EXPECT_EQ(snapshot.frames(), 1u);
+
+	for (TactileValue::Mode mode : snapshot.modes()) {
+		EXPECT_EQ(snapshot.read(mode, values.data()), 1u);
+		array.getValues(mode, expected);
+		for (size_t i = 0; i < n; ++i)
+			EXPECT_FLOAT_EQ(values[i], expected[i]) << i;
+	}
+}
+
+TEST(OutputSnapshot, threads)
+{
+	const size_t n = 1000, frames = 2000;
+	TactileValueArray array(n);
+	OutputSnapshot snapshot(n, { TactileValue::rawCurrent });
+	std::atomic<bool> done(false);
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < 2; ++r)
+		readers.emplace_back([&]() {
+			std::vector<float> values(n);
+			uint64_t last = 0;
+			while (!done.load()) {
+				uint64_t frame = snapshot.read(TactileValue::rawCurrent, values.data());
+				EXPECT_GE(frame, last);  // frames never go back in time
+				last = frame;
+				if (frame == 0) continue;
+				// all values belong to the same frame
+				for (size_t i = 0; i < n; ++i)
+					ASSERT_EQ(values[i], frame - 1) << i;
+			}
+		});
+
+	std::vector<float> data(n);
+	for (size_t f = 0; f < frames; ++f) {
+		std::fill(data.begin(), data.end(), f);
+		array.updateValues(data.begin(), data.end());
+		snapshot.publish(array);
+	}
+	done = true;
+	for (auto &reader : readers)
+		reader.join();
+	EXPECT_EQ(snapshot.frames(), frames);
+}
@@ -24,6 +24,11 @@
 
 #include <gtest/gtest.h>
 #include "PieceWiseLinearCalib.h"
+#include "LookupTableCalib.h"
+#include "CalibrationFile.h"
+#include <fstream>
+#include <math.h>
+#include <vector>
 
 using namespace tactile;
 
@@ -64,6 +69,19 @@ TEST(PieceWiseLinearCalib, two_slopes)
 	EXPECT_FLOAT_EQ(c.map(175), 4);
 	EXPECT_FLOAT_EQ(c.map(200), 5);
 	EXPECT_FLOAT_EQ(c.map(201), 5);
+	EXPECT_FLOAT_EQ(c.map(NAN), 5);  // NaN maps to the last value
+}
+
+TEST(PieceWiseLinearCalib, copy_empty)
+{
+	PieceWiseLinearCalib empty;
+	PieceWiseLinearCalib copy(empty);
+	copy = PieceWiseLinearCalib(PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 2 } }));
+	EXPECT_FLOAT_EQ(copy.map(0.5), 1);
+	copy = empty;
+	PieceWiseLinearCalib other(copy);
+	other.init(PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 4 } }));
+	EXPECT_FLOAT_EQ(other.map(0.5), 2);
 }
 
 TEST(PieceWiseLinearCalib, ranges)
@@ -121,3 +139,140 @@ TEST(PieceWiseLinearCalib, yaml)
 	ASSERT_THROW(PieceWiseLinearCalib::load("trapez.yaml"), std::runtime_error);
 #endif
 }
+
+// compare against straightforward interpolation on the original map
+static float reference(const PieceWiseLinearCalib::CalibrationMap &values, float x)
+{
+	auto next = values.upper_bound(x);
+	if (next == values.begin()) return values.begin()->second;
+	if (next == values.end()) return values.rbegin()->second;
+	auto prev = std::prev(next);
+	return prev->second +
+	       (x - prev->first) / (next->first - prev->first) * (next->second - prev->second);
+}
+
+TEST(PieceWiseLinearCalib, compiled_lookup)
+{
+	PieceWiseLinearCalib::CalibrationMap uniform, irregular;
+	for (int k = 0; k < 50; ++k) {
+		uniform[0.1 * k] = sin(0.1 * k);
+		irregular[0.01 * k * k] = cos(0.1 * k);
+	}
+	for (const auto *values : { &uniform, &irregular }) {
+		PieceWiseLinearCalib c(*values);
+		for (float x = -1; x < 30; x += 0.013)
+			EXPECT_NEAR(c.map(x), reference(*values, x), 1e-5) << x;
+		// exact values at knots
+		for (const auto &knot : *values)
+			EXPECT_FLOAT_EQ(c.map(knot.first), knot.second);
+	}
+}
+
+TEST(PieceWiseLinearCalib, batch)
+{
+	PieceWiseLinearCalib c(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 1 }, { 2, 1 }, { 3, 0 } }));
+	std::vector<float> in = { -1, 0, 0.2, 1, 1.5, 2.2, 3, 4, NAN, INFINITY };
+	std::vector<float> out(in.size());
+	c.map(in.data(), out.data(), in.size());
+	for (size_t i = 0; i + 2 < in.size(); ++i)
+		EXPECT_EQ(out[i], c.map(in[i]));
+	EXPECT_TRUE(isnan(out[in.size() - 2]));
+	EXPECT_EQ(out.back(), INFINITY);
+
+	// in-place mapping
+	c.map(in.data(), in.data(), in.size());
+	for (size_t i = 0; i + 2 < in.size(); ++i)
+		EXPECT_EQ(in[i], out[i]);
+}
+
+TEST(LookupTableCalib, from_PieceWiseLinearCalib)
+{
+	PieceWiseLinearCalib pwl(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 100, 1 }, { 200, 5 } }));
+	LookupTableCalib lut(pwl, 0, 4095);
+	EXPECT_EQ(lut.input_range(), Range(0, 4095));
+	EXPECT_EQ(lut.output_range(), Range(0, 5));
+
+	std::vector<uint16_t> codes = { 0, 20, 100, 125, 200, 4095, 65535 };
+	std::vector<float> out(codes.size());
+	lut.map(codes.data(), out.data(), codes.size());
+	for (size_t i = 0; i < codes.size(); ++i)
+		EXPECT_FLOAT_EQ(out[i], pwl.map(codes[i]));
+	EXPECT_FLOAT_EQ(lut.map(20.5f), pwl.map(20.5f));
+
+	// signed codes are clipped at the lower table bound
+	std::vector<int16_t> signed_codes = { -100, 0, 150 };
+	lut.map(signed_codes.data(), out.data(), signed_codes.size());
+	EXPECT_FLOAT_EQ(out[0], 0);
+	EXPECT_FLOAT_EQ(out[1], 0);
+	EXPECT_FLOAT_EQ(out[2], 3);
+
+	// generic Calibration interface for integer codes
+	pwl.map(codes.data(), out.data(), codes.size());
+	for (size_t i = 0; i < codes.size(); ++i)
+		EXPECT_FLOAT_EQ(out[i], lut[codes[i]]);
+}
+
+TEST(CalibrationFile, roundtrip)
+{
+	const std::string sFile = ::testing::TempDir() + "calibration.bin";
+	PieceWiseLinearCalib::CalibrationMap irregular({ { 0, 0 }, { 0.5, 2 }, { 10, 3 } });
+	CalibrationFile::save(sFile, { { "trapez", { { 0, 0 }, { 1, 1 }, { 2, 1 }, { 3, 0 } } },
+	                               { "irregular", irregular } });
+
+	std::shared_ptr<PieceWiseLinearCalib> trapez;
+	{
+		CalibrationFile file(sFile);
+		ASSERT_EQ(file.size(), 2u);
+		EXPECT_EQ(file.name(1), "irregular");
+		EXPECT_EQ(file.curve("unknown"), nullptr);
+		trapez = file.curve("trapez");
+	}
+	// curve keeps mapping alive beyond lifetime of file
+	test_trapez(*trapez);
+	EXPECT_EQ(trapez->output_range(), Range(0, 1));
+
+	PieceWiseLinearCalib copy(*CalibrationFile(sFile).curve(1));
+	PieceWiseLinearCalib ref(irregular);
+	for (float x = -1; x < 11; x += 0.25)
+		EXPECT_EQ(copy.map(x), ref.map(x));
+	EXPECT_EQ(copy.input_range(), Range(0, 10));
+}
+
+TEST(CalibrationFile, invalid)
+{
+	const std::string sFile = ::testing::TempDir() + "calibration.bin";
+	CalibrationFile::save(sFile, { { "linear", { { 0, 0 }, { 1, 1 } } } });
+	{  // bump version
+		std::fstream f(sFile, std::ios::in | std::ios::out | std::ios::binary);
+		const uint32_t version = CalibrationFile::VERSION + 1;
+		f.seekp(offsetof(CalibrationFile::Header, version));
+		f.write(reinterpret_cast<const char *>(&version), sizeof(version));
+	}
+	EXPECT_THROW(CalibrationFile file(sFile), std::runtime_error);
+	EXPECT_THROW(CalibrationFile file("trapez.yaml"), std::runtime_error);
+	EXPECT_THROW(CalibrationFile file("nonexisting.bin"), std::runtime_error);
+
+	EXPECT_THROW(CalibrationFile::save(sFile, { { "single", { { 0, 1 } } } }),
+	             std::invalid_argument);
+
+	// corrupt sizes must neither overflow the bounds checks nor read beyond the file
+	const size_t curveOffset = 64;  // curve headers follow the aligned file header
+	auto corrupt = [&sFile](size_t pos, const void *data, size_t size) {
+		CalibrationFile::save(sFile, { { "linear", { { 0, 0 }, { 1, 1 } } } });
+		std::fstream f(sFile, std::ios::in | std::ios::out | std::ios::binary);
+		f.seekp(pos);
+		f.write(static_cast<const char *>(data), size);
+	};
+	const uint32_t numCurves = 0xffffffff;
+	corrupt(offsetof(CalibrationFile::Header, numCurves), &numCurves, sizeof(numCurves));
+	EXPECT_THROW(CalibrationFile file(sFile), std::runtime_error);
+	const uint64_t offset = uint64_t(-24);  // wraps around when adding the curve size
+	corrupt(curveOffset + offsetof(CalibrationFile::CurveHeader, offset), &offset, sizeof(offset));
+	EXPECT_THROW(CalibrationFile file(sFile), std::runtime_error);
+	const uint32_t numKnots = 0xffffffff;
+	corrupt(curveOffset + offsetof(CalibrationFile::CurveHeader, numKnots), &numKnots,
+	        sizeof(numKnots));
+	EXPECT_THROW(CalibrationFile file(sFile), std::runtime_error);
+}
@@ -0,0 +1,194 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "StateCheckpoint.h"
+#include <fstream>
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+using namespace tactile;
+
+static std::vector<float> frame(size_t n, int k)
+{
+	std::vector<float> result(n);
+	for (size_t i = 0; i < n; ++i)
+		result[i] = 5 * sin(0.3 * k + i) + (k % 7 == 0 ? 10 : 0);
+	return result;
+}
+
+static void expect_equal(const TactileValueArray &a, const TactileValueArray &b)
+{
+	for (int m = 0; m <= TactileValue::lastMode; ++m) {
+		const TactileValue::Mode mode = static_cast<TactileValue::Mode>(m);
+		std::vector<float> va = a.getValues(mode), vb = b.getValues(mode);
+		ASSERT_EQ(va.size(), vb.size());
+		EXPECT_EQ(memcmp(va.data(), vb.data(), va.size() * sizeof(float)), 0)
+		    << TactileValue::getModeName(mode);
+	}
+}
+
+TEST(StateCheckpoint, buffer)
+{
+	const size_t n = 19;
+	TactileValueArray array(n);
+	array.setMeanLambda(0.5);
+	for (int k = 0; k < 30; ++k)
+		array.updateValues(frame(n, k));
+
+	std::vector<char> buffer(StateCheckpoint::size(n));
+	EXPECT_EQ(StateCheckpoint::save(array, buffer.data(), buffer.size()), buffer.size());
+	EXPECT_THROW(StateCheckpoint::save(array, buffer.data(), buffer.size() - 1), std::length_error);
+
+	TactileValueArray restored;
+	StateCheckpoint::load(restored, buffer.data(), buffer.size());
+	ASSERT_EQ(restored.size(), n);
+	EXPECT_FLOAT_EQ(restored.getMeanLambda(), 0.5);
+	expect_equal(array, restored);
+
+	// restored array continues exactly like the original one
+	for (int k = 30; k < 40; ++k) {
+		array.updateValues(frame(n, k));
+		restored.updateValues(frame(n, k));
+	}
+	expect_equal(array, restored);
+
+	TactileValueArray other(n + 1);
+	EXPECT_THROW(StateCheckpoint::load(other, buffer.data(), buffer.size()), std::runtime_error);
+	EXPECT_THROW(StateCheckpoint::load(other, buffer.data(), buffer.size() - 1), std::runtime_error);
+}
+
+TEST(StateCheckpoint, corrupt)
+{
+	const size_t n = 19;
+	TactileValueArray array(n);
+	std::vector<char> buffer(StateCheckpoint::size(n));
+	StateCheckpoint::save(array, buffer.data(), buffer.size());
+	StateCheckpoint::Header header;
+	memcpy(&header, buffer.data(), sizeof(header));
+
+	// corrupt header fields must neither overflow size computations nor read beyond the buffer
+	auto load_corrupt = [&buffer, &header](uint64_t numTaxels, uint64_t stride,
+	                                       uint64_t numOverrides) {
+		std::vector<char> corrupt(buffer);
+		StateCheckpoint::Header h = header;
+		h.numTaxels = numTaxels;
+		h.stride = stride;
+		h.numOverrides = numOverrides;
+		memcpy(corrupt.data(), &h, sizeof(h));
+		TactileValueArray restored;
+		StateCheckpoint::load(restored, corrupt.data(), corrupt.size());
+	};
+	EXPECT_NO_THROW(load_corrupt(header.numTaxels, header.stride, header.numOverrides));
+	EXPECT_THROW(load_corrupt(uint64_t(1) << 62, header.stride, 0), std::runtime_error);
+	EXPECT_THROW(load_corrupt(n, uint64_t(1) << 62, 0), std::runtime_error);
+	EXPECT_THROW(load_corrupt(n, header.stride + 16, 0), std::runtime_error);
+	EXPECT_THROW(load_corrupt(n, header.stride, uint64_t(1) << 62), std::runtime_error);
+	EXPECT_THROW(load_corrupt(n, header.stride, uint64_t(-1)), std::runtime_error);
+	EXPECT_THROW(load_corrupt(n, header.stride, 5), std::runtime_error);
+
+	// invalid override records are rejected before the array is modified
+	array.setParameters(3, TactileParams());
+	array.setRangeLambda(0.5);
+	buffer.resize(StateCheckpoint::size(n, 1));
+	StateCheckpoint::save(array, buffer.data(), buffer.size());
+	const uint32_t taxel = n;  // first override record follows the shared parameters
+	memcpy(buffer.data() + StateCheckpoint::size(n) - 64 + 3 * sizeof(float), &taxel,
+	       sizeof(taxel));
+	TactileValueArray target(n);
+	target.updateValues(std::vector<float>(n, 1.f));
+	target[5].setMeanLambda(0.3);
+	EXPECT_THROW(StateCheckpoint::load(target, buffer.data(), buffer.size()), std::runtime_error);
+	EXPECT_EQ(target.getValues(TactileValue::rawCurrent), std::vector<float>(n, 1.f));
+	EXPECT_EQ(target.numOverrides(), 1u);
+	EXPECT_FLOAT_EQ(target.getRangeLambda(), TactileParams().rangeLambda);
+
+	// truncated header
+	TactileValueArray restored;
+	EXPECT_THROW(StateCheckpoint::load(restored, buffer.data(), sizeof(header) - 1),
+	             std::runtime_error);
+}
+
+TEST(StateCheckpoint, overrides)
+{
+	const size_t n = 10;
+	TactileValueArray array(n);
+	array.setRangeLambda(0.99);
+	array[3].setMeanLambda(0.2);
+	array[7].setReleaseDecay(0.5);
+	for (int k = 0; k < 30; ++k)
+		array.updateValues(frame(n, k));
+
+	std::vector<char> buffer(StateCheckpoint::size(n, array.numOverrides()));
+	EXPECT_EQ(StateCheckpoint::save(array, buffer.data(), buffer.size()), buffer.size());
+	TactileValueArray restored;
+	StateCheckpoint::load(restored, buffer.data(), buffer.size());
+	EXPECT_EQ(restored.numOverrides(), 2u);
+	EXPECT_FLOAT_EQ(restored.getRangeLambda(), 0.99);
+	EXPECT_FLOAT_EQ(restored[3].getMeanLambda(), 0.2);
+	EXPECT_FLOAT_EQ(restored[7].getReleaseDecay(), 0.5);
+	expect_equal(array, restored);
+
+	// restored array continues exactly like the original one
+	for (int k = 30; k < 40; ++k) {
+		array.updateValues(frame(n, k));
+		restored.updateValues(frame(n, k));
+	}
+	expect_equal(array, restored);
+}
+
+TEST(StateCheckpoint, file)
+{
+	const std::string sFile = ::testing::TempDir() + "checkpoint.bin";
+	TactileValueArray array(7);
+	for (int k = 0; k < 10; ++k)
+		array.updateValues(frame(7, k));
+	StateCheckpoint::save(array, sFile);
+
+	TactileValueArray restored;
+	StateCheckpoint::load(restored, sFile);
+	expect_equal(array, restored);
+
+	// overrides exceeding the padding of the shared parameters
+	for (size_t i = 1; i < 6; ++i)
+		array[i].setMeanLambda(0.1f * i);
+	ASSERT_EQ(array.numOverrides(), 5u);
+	StateCheckpoint::save(array, sFile);
+	TactileValueArray withOverrides;
+	StateCheckpoint::load(withOverrides, sFile);
+	EXPECT_EQ(withOverrides.numOverrides(), 5u);
+	for (size_t i = 0; i < 7; ++i)
+		EXPECT_EQ(withOverrides.parameters(i), array.parameters(i)) << i;
+
+	{  // bump version
+		std::fstream f(sFile, std::ios::in | std::ios::out | std::ios::binary);
+		const uint32_t version = StateCheckpoint::VERSION + 1;
+		f.seekp(offsetof(StateCheckpoint::Header, version));
+		f.write(reinterpret_cast<const char *>(&version), sizeof(version));
+	}
+	EXPECT_THROW(StateCheckpoint::load(restored, sFile), std::runtime_error);
+	EXPECT_THROW(StateCheckpoint::load(restored, "trapez.yaml"), std::runtime_error);
+	EXPECT_THROW(StateCheckpoint::load(restored, "nonexisting.bin"), std::runtime_error);
+}
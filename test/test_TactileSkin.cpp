@@ -0,0 +1,153 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "TactileSkin.h"
+#include "PieceWiseLinearCalib.h"
+#include <math.h>
+#include <stdexcept>
+
+using namespace tactile;
+
+TEST(ThreadPool, run)
+{
+	ThreadPool pool(4);
+	ASSERT_EQ(pool.size(), 4u);
+	std::vector<int> calls(pool.size(), 0);
+	for (int k = 0; k < 100; ++k)
+		pool.run([&calls](size_t thread) { ++calls[thread]; });
+	EXPECT_EQ(calls, std::vector<int>(pool.size(), 100));
+
+	EXPECT_THROW(pool.run([](size_t thread) {
+		if (thread == 2) throw std::runtime_error("failure");
+	}),
+	             std::runtime_error);
+	// pool is still usable
+	pool.run([&calls](size_t thread) { ++calls[thread]; });
+	EXPECT_EQ(calls[3], 101);
+}
+
+static bool same(float a, float b)
+{
+	return a == b || (isnan(a) && isnan(b));
+}
+
+TEST(TactileSkin, equals_sequential)
+{
+	const std::vector<size_t> sizes = { 100, 3000, 17, 2048, 0, 1500 };
+	auto calib = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 1, 2 }, { 2, 3 } }));
+
+	for (size_t threads : { 1, 3, 4 }) {
+		TactileSkin skin(threads);
+		EXPECT_EQ(skin.numThreads(), threads);
+		std::vector<TactileValueArray> arrays;
+		for (size_t n : sizes) {
+			skin.add(n);
+			arrays.emplace_back(n);
+		}
+		ASSERT_EQ(skin.size(), sizes.size());
+		EXPECT_EQ(skin.offset(2), 3100u);
+		skin[1].calibrations().set(10, 2000, skin[1].calibrations().add(calib));
+		arrays[1].calibrations().set(10, 2000, arrays[1].calibrations().add(calib));
+
+		std::vector<float> frame(skin.numTaxels());
+		for (int k = 0; k < 5; ++k) {
+			for (size_t i = 0; i < frame.size(); ++i)
+				frame[i] = sinf(i * (k + 1)) * (1 + i % 3);
+			skin.updateValues(frame);
+			for (size_t a = 0; a < arrays.size(); ++a)
+				arrays[a].updateValues(frame.begin() + skin.offset(a),
+				                       frame.begin() + skin.offset(a + 1));
+		}
+
+		std::vector<float> values(skin.numTaxels());
+		std::vector<float> results(skin.size());
+		for (int m = 0; m <= TactileValue::lastMode; ++m) {
+			const auto mode = TactileValue::Mode(m);
+			skin.getValues(mode, values.data());
+			skin.accumulate(mode, TactileValueArray::SumPositive, results.data());
+			for (size_t a = 0; a < arrays.size(); ++a) {
+				const auto expected = arrays[a].getValues(mode);
+				for (size_t i = 0; i < expected.size(); ++i)
+					ASSERT_TRUE(same(values[skin.offset(a) + i], expected[i]));
+				EXPECT_TRUE(same(results[a], arrays[a].accumulate(mode, TactileValueArray::SumPositive)));
+			}
+		}
+	}
+}
+
+TEST(TactileSkin, sparse)
+{
+	const std::vector<size_t> sizes = { 3000, 100, 2500 };
+	for (size_t threads : { 1, 3, 4 }) {
+		TactileSkin skin(threads);
+		std::vector<TactileValueArray> arrays;
+		for (size_t n : sizes) {
+			skin.add(n);
+			arrays.emplace_back(n);
+		}
+		for (size_t a : { 0, 2 }) {
+			skin[a].setDeadband(0.5f);
+			arrays[a].setDeadband(0.5f);
+		}
+
+		std::vector<float> frame(skin.numTaxels());
+		for (int k = 0; k < 10; ++k) {
+			for (size_t i = 0; i < frame.size(); ++i)
+				frame[i] = sinf(i * (k + 1)) * (1 + i % 3);
+			skin.updateValues(frame);
+			for (size_t a = 0; a < arrays.size(); ++a)
+				arrays[a].updateValues(frame.begin() + skin.offset(a),
+				                       frame.begin() + skin.offset(a + 1));
+		}
+
+		for (size_t a = 0; a < arrays.size(); ++a) {
+			EXPECT_EQ(skin[a].activeTaxels(), arrays[a].activeTaxels());
+			for (size_t i = 0; i < sizes[a]; ++i) {
+				ASSERT_EQ(skin[a].pending(i), arrays[a].pending(i));
+				ASSERT_TRUE(same(skin[a][i].value(TactileValue::dynMean),
+				                 arrays[a][i].value(TactileValue::dynMean)));
+			}
+		}
+		EXPECT_FALSE(skin[0].activeTaxels().empty());
+	}
+}
+
+TEST(TactileSkin, codes)
+{
+	TactileSkin skin(2);
+	skin.add(2000);
+	skin.add(3000);
+	std::vector<uint16_t> codes(skin.numTaxels());
+	for (size_t i = 0; i < codes.size(); ++i)
+		codes[i] = i;
+	skin.updateValues(codes);
+
+	std::vector<TactileValueArray::Accumulation> results(skin.size());
+	skin.accumulateAll(TactileValue::rawCurrent, results.data(), false);
+	EXPECT_EQ(results[1][TactileValueArray::Min], 2000);
+	EXPECT_EQ(results[1][TactileValueArray::Max], 4999);
+	EXPECT_EQ(results[1][TactileValueArray::CountPositive], 3000);
+}
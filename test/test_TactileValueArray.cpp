@@ -26,7 +26,10 @@
 
 #include <gtest/gtest.h>
 #include "TactileValueArray.h"
+#include "PieceWiseLinearCalib.h"
+#include "LookupTableCalib.h"
 #include <math.h>
+#include <string.h>
 #include <map>
 
 using namespace tactile;
@@ -79,6 +82,51 @@ TEST(TactileValueArray, update_neg_offset)
 		EXPECT_EQ(stored[i + offset], VALUES[i]);
 }
 
+TEST(TactileValueArray, copy)
+{
+	const size_t n = 5;
+	std::unique_ptr<TactileValueArray> source(new TactileValueArray(n));
+	source->updateValues(std::vector<float>{ 1, 2, 3, 4, 5 });
+	TactileValueArray copy(*source);
+	TactileValueArray assigned;
+	assigned = *source;
+	const std::vector<float> expected = source->getValues(TactileValue::rawMean);
+	source.reset();  // copies must not refer to the storage of the source
+
+	EXPECT_EQ(copy.getValues(TactileValue::rawMean), expected);
+	EXPECT_EQ(assigned.getValues(TactileValue::rawMean), expected);
+	// copies are updated independently
+	copy.updateValues(std::vector<float>{ 0, 0, 0, 0, 0 });
+	EXPECT_EQ(assigned.getValues(TactileValue::rawMean), expected);
+	EXPECT_NE(copy.getValues(TactileValue::rawMean), expected);
+}
+
+TEST(TactileValueArray, move)
+{
+	TactileValueArray source(4);
+	source.updateValues(std::vector<float>{ 1, 2, 3, 4 });
+	const std::vector<float> expected = source.getValues(TactileValue::rawMean);
+
+	TactileValueArray moved(std::move(source));
+	EXPECT_EQ(moved.getValues(TactileValue::rawMean), expected);
+	EXPECT_EQ(source.size(), 0u);
+	EXPECT_EQ(source.capacity(), 0u);
+
+	// the moved-from array is usable and independent of the moved-to one
+	source.init(4);
+	source.updateValues(std::vector<float>{ 0, 0, 0, 0 });
+	EXPECT_EQ(moved.getValues(TactileValue::rawMean), expected);
+	EXPECT_FLOAT_EQ(moved[0].value(TactileValue::rawCurrent), 1);
+
+	TactileValueArray assigned;
+	assigned = std::move(moved);
+	EXPECT_EQ(assigned.getValues(TactileValue::rawMean), expected);
+	EXPECT_TRUE(moved.empty());
+	moved = std::move(source);
+	EXPECT_EQ(moved.getValues(TactileValue::rawCurrent), std::vector<float>(4, 0));
+	EXPECT_EQ(assigned.getValues(TactileValue::rawMean), expected);
+}
+
 TEST(TactileValueArray, getValues)
 {
 	int offset = 2;
@@ -117,3 +165,690 @@ TEST(TactileValueArray, accumulate)
 		EXPECT_FLOAT_EQ(sensor.accumulate(TactileValue::rawMean, it->first, false), it->second);
 	}
 }
+
+TEST(TactileValueArray, accumulate_static_mode)
+{
+	TactileValueArray sensor(1000);
+	for (int k = 0; k < 5; ++k) {
+		std::vector<float> frame(sensor.size());
+		for (size_t i = 0; i < frame.size(); ++i)
+			frame[i] = sinf(i + k) * (1 + i % 7);
+		sensor.updateValues(frame);
+	}
+	const auto values = sensor.getValues(TactileValue::dynCurrentRelease);
+	for (int m = 0; m < TactileValueArray::NUM_REDUCTIONS; ++m) {
+		const auto mode = TactileValueArray::AccMode(m);
+		// reference: sequential accumulation of valid values
+		float expected = mode == TactileValueArray::Min ? FLT_MAX :
+		                 mode == TactileValueArray::Max ? -FLT_MAX : 0;
+		for (float v : values)
+			switch (mode) {
+				case TactileValueArray::Sum: expected += v; break;
+				case TactileValueArray::SumPositive: expected += v > 0 ? v : 0; break;
+				case TactileValueArray::SumNegative: expected += v < 0 ? v : 0; break;
+				case TactileValueArray::CountPositive: expected += v > 0; break;
+				case TactileValueArray::CountNegative: expected += v < 0; break;
+				case TactileValueArray::Min: expected = std::min(expected, v); break;
+				case TactileValueArray::Max: expected = std::max(expected, v); break;
+				default: break;
+			}
+		const float fAcc = sensor.accumulate(TactileValue::dynCurrentRelease, mode, false);
+		EXPECT_NEAR(fAcc, expected, 1e-4 * fabs(expected)) << TactileValueArray::getModeName(mode);
+		EXPECT_EQ(fAcc, TactileValueArray::accumulate(values, mode, false));
+		EXPECT_EQ(fAcc / sensor.size(), TactileValueArray::accumulate(values, mode, true));
+		EXPECT_EQ(fAcc,
+		          sensor.accumulate([](const TactileValueArray::ConstReference &taxel) {
+			          return taxel.value(TactileValue::dynCurrentRelease);
+		          }, mode, false));
+	}
+	EXPECT_EQ(sensor.accumulate(TactileValue::dynMean, TactileValueArray::Max),
+	          (sensor.accumulate<TactileValue::dynMean, TactileValueArray::Max>()));
+	EXPECT_EQ(sensor.accumulate(TactileValue::rawMean, TactileValueArray::Sum, false),
+	          sensor.accumulate<TactileValueArray::Sum>(
+	              [](const TactileValueArray::ConstReference &taxel) {
+		              return taxel.value(TactileValue::rawMean);
+	              },
+	              false));
+}
+
+TEST(TactileValueArray, accumulateAll)
+{
+	TactileValueArray sensor(1000);
+	for (int k = 0; k < 5; ++k) {
+		std::vector<float> frame(sensor.size());
+		for (size_t i = 0; i < frame.size(); ++i)
+			frame[i] = cosf(i * k) * (1 + i % 5);
+		sensor.updateValues(frame);
+	}
+	for (int m = 0; m <= TactileValue::lastMode; ++m) {
+		const auto mode = TactileValue::Mode(m);
+		for (bool bMean : { false, true }) {
+			const auto all = sensor.accumulateAll(mode, bMean);
+			for (int acc = 0; acc < TactileValueArray::NUM_REDUCTIONS; ++acc) {
+				const auto accMode = TactileValueArray::AccMode(acc);
+				// bit-identical to individual accumulation (or both NaN)
+				const float expected = sensor.accumulate(mode, accMode, bMean);
+				EXPECT_TRUE(all[accMode] == expected || (isnan(all[accMode]) && isnan(expected)))
+				    << TactileValue::getModeName(mode) << " "
+				    << TactileValueArray::getModeName(accMode);
+			}
+		}
+	}
+	const auto all = sensor.accumulateAll<TactileValue::dynMean>(false);
+	EXPECT_LE(all[TactileValueArray::CountPositive] + all[TactileValueArray::CountNegative],
+	          sensor.size());
+	EXPECT_LE(all[TactileValueArray::Min], all[TactileValueArray::Max]);
+}
+
+TEST(TactileValueArray, accumulate_pairwise)
+{
+	// sequential summation of 1e6 * 0.1f accumulates a large rounding error
+	TactileValueArray::vector_data data(1000000, 0.1f);
+	EXPECT_NEAR(TactileValueArray::accumulate<TactileValueArray::Sum>(data, false), 1e5, 1e-1);
+	TactileValueArray sensor(1000);
+	sensor.setMeanLambda(0.5);
+	EXPECT_FLOAT_EQ(sensor.getMeanLambda(), 0.5);
+}
+
+TEST(TactileValueArray, quantile)
+{
+	TactileValueArray::vector_data data = { 5, NAN, 1, 4, 2, 3 };
+	EXPECT_FLOAT_EQ(TactileValueArray::quantile(data, 0.5), 3);
+	EXPECT_FLOAT_EQ(TactileValueArray::accumulate(data, TactileValueArray::Median), 3);
+	EXPECT_FLOAT_EQ(TactileValueArray::quantile(data, 0), 1);
+	EXPECT_FLOAT_EQ(TactileValueArray::quantile(data, 1), 5);
+	EXPECT_FLOAT_EQ(TactileValueArray::quantile(data, 0.1), 1.4);
+	data.pop_back();  // even number of valid values
+	EXPECT_FLOAT_EQ(TactileValueArray::quantile(data, 0.5), 3);
+	EXPECT_TRUE(isnan(TactileValueArray::quantile({ NAN }, 0.5)));
+
+	// compare with sorting
+	TactileValueArray sensor(1001);
+	std::vector<float> frame(sensor.size());
+	for (size_t i = 0; i < frame.size(); ++i)
+		frame[i] = sinf(i);
+	sensor.updateValues(frame);
+	std::sort(frame.begin(), frame.end());
+	EXPECT_EQ(sensor.accumulate(TactileValue::rawCurrent, TactileValueArray::Median), frame[500]);
+	EXPECT_EQ(sensor.quantile(TactileValue::rawCurrent, 0.9), frame[900]);
+	auto raw = [](const TactileValueArray::ConstReference &taxel) {
+		return taxel.value(TactileValue::rawCurrent);
+	};
+	EXPECT_EQ(sensor.accumulate(raw, TactileValueArray::Median), frame[500]);
+}
+
+TEST(TactileValueArray, histogram)
+{
+	TactileValueArray::vector_data data = { -1, 0, 0.5, 1, 1.5, 2.5, 3, 10, NAN };
+	std::vector<size_t> bins(3);
+	TactileValueArray::histogram(data, 0, 3, bins);
+	EXPECT_EQ(bins, std::vector<size_t>({ 3, 2, 3 }));
+
+	TactileValueArray sensor(1000);
+	std::vector<float> frame(sensor.size());
+	for (size_t i = 0; i < frame.size(); ++i)
+		frame[i] = i % 10;
+	sensor.updateValues(frame);
+	bins.assign(5, 42);
+	sensor.histogram(TactileValue::rawCurrent, 0, 10, bins);
+	EXPECT_EQ(bins, std::vector<size_t>(5, 200));
+}
+
+// feed identical random sequence into TactileValueArray and separate TactileValue instances
+static void compare_with_scalar(TactileValueArray &array, std::vector<TactileValue> &scalar,
+                                size_t frames)
+{
+	std::vector<float> frame(scalar.size());
+	srand(42);
+	for (size_t f = 0; f < frames; ++f) {
+		for (size_t i = 0; i < frame.size(); ++i) {
+			// random walk with occasional jumps and invalid values
+			float r = float(rand()) / RAND_MAX;
+			frame[i] = (r < 0.02) ? NAN : (r < 0.1 ? 10 * r : frame[i] + r - 0.5);
+		}
+		array.updateValues(frame);
+		for (size_t i = 0; i < frame.size(); ++i)
+			scalar[i].update(frame[i]);
+
+		for (int m = 0; m <= TactileValue::lastMode; ++m) {
+			auto mode = static_cast<TactileValue::Mode>(m);
+			std::vector<float> values = array.getValues(mode);
+			for (size_t i = 0; i < values.size(); ++i) {
+				float expected = scalar[i].value(mode);
+				if (isnan(expected))
+					EXPECT_TRUE(isnan(values[i]));
+				else
+					EXPECT_EQ(values[i], expected) << TactileValue::getModeName(mode) << " " << i;
+			}
+		}
+	}
+}
+
+TEST(TactileValueArray, soa_equals_scalar)
+{
+	const size_t n = 37;
+	TactileValueArray array(n);
+	std::vector<TactileValue> scalar(n);
+	array.setMeanLambda(0.5);
+	array.setRangeLambda(0.99);
+	array.setReleaseDecay(0.1);
+	for (auto &s : scalar) {
+		s.setMeanLambda(0.5);
+		s.setRangeLambda(0.99);
+		s.setReleaseDecay(0.1);
+	}
+	compare_with_scalar(array, scalar, 200);
+}
+
+TEST(TactileValueArray, proxy)
+{
+	TactileValueArray array(3);
+	array[1].setMeanLambda(0.2);
+	EXPECT_FLOAT_EQ(array[1].getMeanLambda(), 0.2);
+	EXPECT_FLOAT_EQ(array[0].getMeanLambda(), TactileValue().getMeanLambda());
+
+	array[1].update(2);
+	array[1].update(4);
+	EXPECT_EQ(array[1].absRange(), Range(2, 4));
+	EXPECT_FLOAT_EQ(array[1].value(TactileValue::rawMean), 4 + 0.2 * (2 - 4));
+
+	// stand-alone copy preserves state
+	TactileValue copy = array[1];
+	for (int m = 0; m <= TactileValue::lastMode; ++m) {
+		auto mode = static_cast<TactileValue::Mode>(m);
+		EXPECT_EQ(copy.value(mode), array[1].value(mode));
+	}
+
+	// iterators
+	size_t count = 0;
+	for (auto it = array.begin(); it != array.end(); ++it, ++count)
+		it->init(0, 1);
+	EXPECT_EQ(count, array.size());
+	EXPECT_EQ(array.end() - array.begin(), ptrdiff_t(array.size()));
+	EXPECT_TRUE(isnan(array[1].value(TactileValue::rawCurrent)));
+
+	// growing keeps parameters of existing taxels
+	array.init(5);
+	EXPECT_FLOAT_EQ(array[1].getMeanLambda(), 0.2);
+	EXPECT_FLOAT_EQ(array[4].getMeanLambda(), TactileValue().getMeanLambda());
+}
+
+TEST(TactileValueArray, overrides)
+{
+	const size_t n = 37;
+	TactileValueArray array(n);
+	TactileParams shared;
+	shared.meanLambda = 0.5;
+	array.setParameters(shared);
+	EXPECT_EQ(array.numOverrides(), 0u);
+	// overrides at the borders, adjacent ones, and within vector blocks
+	for (size_t i : { 0, 5, 6, 17, 36 })
+		array[i].setRangeLambda(0.9 + 0.001 * i);
+	array[6].setReleaseDecay(0.2);
+	EXPECT_EQ(array.numOverrides(), 5u);
+	EXPECT_FLOAT_EQ(array.getRangeLambda(), shared.rangeLambda);  // shared value
+
+	std::vector<TactileValue> scalar(n);
+	for (size_t i = 0; i < n; ++i) {
+		scalar[i].setMeanLambda(array[i].getMeanLambda());
+		scalar[i].setRangeLambda(array[i].getRangeLambda());
+		scalar[i].setReleaseDecay(array[i].getReleaseDecay());
+	}
+	compare_with_scalar(array, scalar, 200);
+
+	// setting a parameter for all taxels keeps the other overridden parameters
+	array.setMeanLambda(0.3);
+	EXPECT_FLOAT_EQ(array[5].getMeanLambda(), 0.3);
+	EXPECT_FLOAT_EQ(array[5].getRangeLambda(), 0.905);
+	array.clearOverrides();
+	EXPECT_EQ(array[5].getRangeLambda(), array.getRangeLambda());
+}
+
+template <TactileValue::Mode mode>
+static void compare_modes(const TactileValueArray &array)
+{
+	std::vector<float> values;
+	array.getValues<mode>(values);
+	ASSERT_EQ(values.size(), array.size());
+	for (size_t i = 0; i < values.size(); ++i) {
+		float expected = array[i].value(mode);
+		if (isnan(expected))
+			EXPECT_TRUE(isnan(values[i]));
+		else
+			EXPECT_EQ(values[i], expected) << TactileValue::getModeName(mode) << " " << i;
+	}
+}
+
+TEST(TactileValueArray, getValues_static_mode)
+{
+	TactileValueArray array(VALUES.size() + 1);  // last taxel stays uninitialized
+	array.updateValues(VALUES);
+	std::vector<int> released = { 2, 2, -3, 1, 0 };
+	array.updateValues(released);  // enter release mode for some taxels
+	array.updateValues(released);
+	ASSERT_LT(array[2].value(TactileValue::dynCurrentRelease), 0);
+
+	compare_modes<TactileValue::rawCurrent>(array);
+	compare_modes<TactileValue::rawMean>(array);
+	compare_modes<TactileValue::absCurrent>(array);
+	compare_modes<TactileValue::absMean>(array);
+	compare_modes<TactileValue::dynCurrent>(array);
+	compare_modes<TactileValue::dynMean>(array);
+	compare_modes<TactileValue::dynCurrentRelease>(array);
+	compare_modes<TactileValue::dynMeanRelease>(array);
+
+	std::vector<float> values(2);
+	array.getValues<TactileValue::rawCurrent>(values, -3);
+	EXPECT_EQ(values[0], released[3]);
+	EXPECT_EQ(values[1], released[4]);
+}
+
+TEST(TactileValueArray, getValues_multi_mode)
+{
+	const size_t n = 300;  // more than a single block
+	TactileValueArray array(n);
+	std::vector<float> frame(n);
+	for (size_t f = 0; f < 10; ++f) {
+		for (size_t i = 0; i < n; ++i)
+			frame[i] = (f % 3 == 2) ? 0 : float(i % 7) * f;
+		array.updateValues(frame);
+	}
+
+	std::vector<TactileValue::Mode> modes;
+	for (int m = 0; m <= TactileValue::lastMode; ++m)
+		modes.push_back(static_cast<TactileValue::Mode>(m));
+	std::vector<std::vector<float>> values(modes.size(), std::vector<float>(n - 1));
+	std::vector<TactileValueArray::ModeOutput> outputs;
+	for (size_t m = 0; m < modes.size(); ++m)
+		outputs.push_back({ modes[m], values[m].data() });
+	array.getValues(outputs, n - 1, 1);
+
+	for (size_t m = 0; m < modes.size(); ++m) {
+		std::vector<float> expected(n - 1);
+		array.getValues(modes[m], expected, 1);
+		for (size_t i = 0; i < expected.size(); ++i) {
+			if (isnan(expected[i]))
+				EXPECT_TRUE(isnan(values[m][i]));
+			else  // multiplication with reciprocal might differ by an ulp from division
+				EXPECT_FLOAT_EQ(values[m][i], expected[i]) << TactileValue::getModeName(modes[m]);
+		}
+	}
+}
+
+TEST(TactileValueArray, calibration)
+{
+	auto scale = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 10, 1 } }));
+	auto invert = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 1 }, { 10, 0 } }));
+	TactileValueArray array(5);
+	array[0].setCalibration(scale);
+	array[1].setCalibration(scale);
+	array[3].setCalibration(invert);
+	array.updateValues(std::vector<float>({ 5, 20, 5, 2, NAN }));
+
+	std::vector<float> expected = { 0.5, 1, 5, 0.8 };
+	std::vector<float> values = array.getValues(TactileValue::rawCurrent);
+	for (size_t i = 0; i < expected.size(); ++i)
+		EXPECT_FLOAT_EQ(values[i], expected[i]);
+	EXPECT_TRUE(isnan(values[4]));
+	EXPECT_EQ(array[3].getCalibration(), invert);
+	EXPECT_EQ(array[2].getCalibration(), nullptr);
+}
+
+TEST(TactileValueArray, external_storage)
+{
+	const std::vector<size_t> capacities = { 5, 20, 3 };
+	std::vector<float, AlignedAllocator<float>> arena(TactileValueArray::storageSize(capacities));
+	std::vector<TactileValueArray> arrays =
+	    TactileValueArray::createArrays(arena.data(), capacities);
+	ASSERT_EQ(arrays.size(), 3u);
+
+	TactileValueArray &external = arrays[1];
+	EXPECT_TRUE(external.external());
+	EXPECT_EQ(external.size(), 20u);
+	external.init(10);  // shrink and grow within capacity
+	external[3].setMeanLambda(0.5);
+	external.init(12);
+	EXPECT_EQ(external.capacity(), 20u);
+	EXPECT_FLOAT_EQ(external[3].getMeanLambda(), 0.5);
+	EXPECT_THROW(external.init(21), std::length_error);
+
+	TactileValueArray owned(12);
+	owned[3].setMeanLambda(0.5);
+	EXPECT_FALSE(owned.external());
+	for (int k = 0; k < 10; ++k) {
+		std::vector<float> frame(12);
+		for (size_t i = 0; i < frame.size(); ++i)
+			frame[i] = sin(k + i);
+		owned.updateValues(frame);
+		external.updateValues(frame);
+		arrays[2].updateValues(std::vector<float>(3, k));  // neighbours don't interfere
+	}
+	EXPECT_EQ(external.getValues(TactileValue::dynMean), owned.getValues(TactileValue::dynMean));
+
+	// copies own their storage
+	TactileValueArray copy = external;
+	EXPECT_FALSE(copy.external());
+	copy.reserve(30);  // keeps state
+	EXPECT_EQ(copy[5].value(TactileValue::rawCurrent), owned[5].value(TactileValue::rawCurrent));
+	external.reset();
+	EXPECT_TRUE(isnan(external[5].value(TactileValue::rawCurrent)));
+	EXPECT_FALSE(isnan(copy[5].value(TactileValue::rawCurrent)));
+}
+
+TEST(TactileValueArray, sparse)
+{
+	const size_t n = 100;
+	TactileValueArray array(n), reference(n);
+	EXPECT_FALSE(array.sparse());
+	array.setDeadband(0.5);
+	array.setDeadband(7, 2.0);
+	EXPECT_TRUE(array.sparse());
+	EXPECT_FLOAT_EQ(array.getDeadband(7), 2.0);
+
+	std::vector<float> frame(n, 0.f), output(n);
+	array.updateValues(frame);  // first update activates all taxels
+	reference.updateValues(frame);
+	EXPECT_EQ(array.activeTaxels().size(), n);
+	array.getValues(TactileValue::rawCurrent, output);
+
+	// few changes (filtered individually) and many changes (filtered by vectorized kernel)
+	for (size_t changes : { 3, 60 }) {
+		array.clearActive();
+		EXPECT_TRUE(array.activeTaxels().empty());
+		EXPECT_FALSE(array.isActive(0));
+
+		std::vector<float> masked(n, NAN);
+		for (size_t i = 0; i < n; ++i)
+			frame[i] += i < changes ? 1.f : 0.1f;  // small changes stay within deadband
+		frame[7] += 0.1;                           // still within larger deadband
+		for (size_t i = 0; i < changes; ++i)
+			if (i != 7) masked[i] = frame[i];
+		array.updateValues(frame);
+		reference.updateValues(masked);
+
+		std::vector<uint32_t> expected;
+		for (size_t i = 0; i < changes; ++i)
+			if (i != 7) expected.push_back(i);
+		EXPECT_EQ(array.activeTaxels(), expected);
+		EXPECT_TRUE(array.isActive(0));
+		EXPECT_FALSE(array.isActive(7));
+		EXPECT_FALSE(array.isActive(changes));
+
+		// skipped taxels keep their state, active ones equal a dense update
+		for (int m = 0; m <= TactileValue::lastMode; ++m) {
+			const TactileValue::Mode mode = static_cast<TactileValue::Mode>(m);
+			std::vector<float> a = array.getValues(mode), r = reference.getValues(mode);
+			EXPECT_EQ(memcmp(a.data(), r.data(), n * sizeof(float)), 0)
+			    << TactileValue::getModeName(mode);
+		}
+
+		// patch output with active values only
+		array.getActiveValues(TactileValue::rawCurrent, output.data());
+		EXPECT_EQ(output, array.getValues(TactileValue::rawCurrent));
+
+		std::vector<float> active;
+		for (uint32_t i : array.activeTaxels())
+			active.push_back(output[i]);
+		EXPECT_NEAR(array.accumulateActive(TactileValue::rawCurrent, TactileValueArray::Sum, false),
+		            TactileValueArray::accumulate(active, TactileValueArray::Sum, false), 1e-4);
+		EXPECT_EQ(array.accumulateActive(TactileValue::rawCurrent, TactileValueArray::Max, false),
+		          TactileValueArray::accumulate(active, TactileValueArray::Max, false));
+		EXPECT_EQ(array.accumulateActive(TactileValue::rawCurrent, TactileValueArray::Median),
+		          TactileValueArray::quantile(active, 0.5));
+	}
+
+	// copies keep sparse mode
+	TactileValueArray copy = array;
+	EXPECT_TRUE(copy.sparse());
+	EXPECT_EQ(copy.activeTaxels(), array.activeTaxels());
+}
+
+TEST(TactileValueArray, lazy_decay)
+{
+	const size_t n = 50;
+	TactileValueArray lazy(n), dense(n);
+	lazy.setRangeLambda(0.95);
+	dense.setRangeLambda(0.95);
+	lazy.setDeadband(0.01);
+	lazy.setLazyDecay(true);
+
+	// taxels change rarely, at different frames, and hold their value otherwise
+	std::vector<float> frame(n, 0.f);
+	for (int k = 0; k < 200; ++k) {
+		for (size_t i = 0; i < n; ++i) {
+			if ((k + i) % 37 == 0) frame[i] = k % 3 ? 5 + i : 0;
+		}
+		frame[3] = NAN;  // invalid inputs are ignored, not counted as frames
+		lazy.updateValues(frame);
+		dense.updateValues(frame);
+	}
+	EXPECT_GT(lazy.pending(0), 0u);
+	EXPECT_EQ(lazy.pending(3), 0u);
+	lazy.catchUp();
+	EXPECT_EQ(lazy.pending(0), 0u);
+
+	for (TactileValue::Mode mode : { TactileValue::rawMean, TactileValue::dynCurrent,
+	                                 TactileValue::dynMeanRelease }) {
+		std::vector<float> l = lazy.getValues(mode), d = dense.getValues(mode);
+		for (size_t i = 0; i < n; ++i) {
+			if (isnan(d[i])) {
+				EXPECT_TRUE(isnan(l[i])) << i;
+			} else {
+				EXPECT_NEAR(l[i], d[i], 1e-4) << TactileValue::getModeName(mode) << " " << i;
+			}
+		}
+	}
+
+	// decimation: repeat() equals updating with held values
+	lazy.repeat(10);
+	for (int k = 0; k < 10; ++k)
+		dense.updateValues(frame);
+	std::vector<float> l = lazy.getValues(TactileValue::dynMean);
+	std::vector<float> d = dense.getValues(TactileValue::dynMean);
+	for (size_t i = 0; i < n; ++i) {
+		if (!isnan(d[i])) {
+			EXPECT_NEAR(l[i], d[i], 1e-4) << i;
+		}
+	}
+}
+
+TEST(TactileValueArray, timestamps)
+{
+	const size_t n = 20;
+	TactileValueArray array(n);
+	std::vector<TactileValue> expected(n);
+	array.setTimeConstants(0.01, 0.5, 20);
+	for (size_t i = 0; i < n; ++i) {
+		if (i % 2) array.setTimeConstants(i, 0.002 * (i + 1), 0.1 * (i + 1), i);
+		expected[i].setTimeConstants(array.getMeanTau(i), array.getRangeTau(i), array.getReleaseRate(i));
+	}
+
+	// 1 kHz with jitter and dropped frames
+	std::vector<float> frame(n);
+	double t = 5.0, last = NAN;
+	for (int k = 0; k < 300; ++k) {
+		t += 0.001 * (k % 7 ? 1 + 0.1 * (k % 3) : 4);
+		for (size_t i = 0; i < n; ++i)
+			frame[i] = (k / 50) % 2 ? 10.f + i : i + 0.1f * (k % 5);
+		array.updateValuesAt(frame, t);
+		for (size_t i = 0; i < n; ++i)
+			expected[i].updateElapsed(frame[i], isnan(last) ? 0.f : float(t - last));
+		last = t;
+	}
+	for (TactileValue::Mode mode : { TactileValue::rawMean, TactileValue::dynCurrent,
+	                                 TactileValue::dynMeanRelease }) {
+		std::vector<float> values = array.getValues(mode);
+		for (size_t i = 0; i < n; ++i)
+			EXPECT_NEAR(values[i], expected[i].value(mode), 1e-4)
+			    << TactileValue::getModeName(mode) << " " << i;
+	}
+
+	// decay over a given time doesn't depend on the frame rate
+	TactileValueArray fast(n), slow(n);
+	fast.setTimeConstants(0.02, 0.05, 20);
+	slow.setTimeConstants(0.02, 0.05, 20);
+	for (int k = 0; k <= 100; ++k) {
+		// step at a frame seen at both rates
+		std::fill(frame.begin(), frame.end(), k <= 40 ? 1.f : 0.5f);
+		fast.updateValuesAt(frame, 0.001 * k);
+		if (k % 10 == 0) slow.updateValuesAt(frame, 0.001 * k);
+	}
+	EXPECT_NEAR(fast[0].value(TactileValue::rawMean), slow[0].value(TactileValue::rawMean), 1e-4);
+	EXPECT_NEAR(fast[0].dynRange().max(), slow[0].dynRange().max(), 1e-4);
+}
+
+TEST(TactileValueArray, timestamps_overrides)
+{
+	TactileValueArray array(3);
+	array.setTimeConstants(0.01, 0.5, 20);
+	TactileParams fixed;
+	fixed.meanLambda = 0.2f;
+	fixed.rangeLambda = 0.9f;
+	fixed.releaseDecay = 0.1f;
+	array.setParameters(1, fixed);
+	array.setTimeConstants(2, 0.02, 1.0, 10);
+
+	const std::vector<float> frame = { 1, 2, 3 };
+	array.updateValuesAt(frame, 1.0);
+	array.updateValuesAt(frame, 1.002);
+	// explicitly set lambdas are kept, others are derived from the taxel's own time constants
+	EXPECT_EQ(array.parameters(1), fixed);
+	EXPECT_NEAR(array.parameters(0).meanLambda, expf(-0.002f / 0.01f), 1e-5);
+	EXPECT_NEAR(array.parameters(2).meanLambda, expf(-0.002f / 0.02f), 1e-5);
+	EXPECT_NEAR(array.parameters(2).releaseDecay, 0.002f * 10, 1e-5);
+
+	// setting time constants for the taxel makes it follow the elapsed time again
+	array.setTimeConstants(1, 0.005, 0.5, 20);
+	array.updateValuesAt(frame, 1.004);
+	EXPECT_NEAR(array.parameters(1).meanLambda, expf(-0.002f / 0.005f), 1e-5);
+
+	// pending frames of lazy decay are applied with the lambdas of their own elapsed time
+	const size_t n = 4;
+	TactileValueArray lazy(n), dense(n);
+	for (TactileValueArray *a : { &lazy, &dense }) {
+		a->setTimeConstants(0.01, 0.05, 20);
+		a->setTimeConstants(2, 0.002, 0.02, 50);
+	}
+	lazy.setDeadband(0.5);
+	lazy.setLazyDecay(true);
+	std::vector<float> values(n);
+	double t = 0;
+	for (int k = 0; k < 60; ++k) {
+		t += k < 20 ? 0.001 : k < 40 ? 0.004 : 0.0005;
+		std::fill(values.begin(), values.end(), k < 10 ? float(k % 2) * 10 : 3.f);
+		lazy.updateValuesAt(values, t);
+		dense.updateValuesAt(values, t);
+	}
+	EXPECT_GT(lazy.pending(0), 0u);
+	lazy.catchUp();
+	for (TactileValue::Mode mode : { TactileValue::rawMean, TactileValue::dynCurrent,
+	                                 TactileValue::dynMeanRelease }) {
+		std::vector<float> l = lazy.getValues(mode), d = dense.getValues(mode);
+		for (size_t i = 0; i < n; ++i)
+			EXPECT_NEAR(l[i], d[i], 1e-4) << TactileValue::getModeName(mode) << " " << i;
+	}
+}
+
+TEST(TactileValueArray, views)
+{
+	// packet of 3-byte header + two interleaved arrays of 5 uint16_t codes each
+	const size_t n = 5, header = 3;
+	std::vector<char> packet(header + 2 * n * sizeof(uint16_t));
+	for (uint16_t i = 0; i < 2 * n; ++i)
+		memcpy(packet.data() + header + i * sizeof(uint16_t), &i, sizeof(i));
+
+	TactileValueArray even, odd;
+	even.updateValues(StridedView<uint16_t>(packet.data() + header, 2 * sizeof(uint16_t), n));
+	odd.updateValues(StridedView<uint16_t>(packet.data() + header + 2, 2 * sizeof(uint16_t), n));
+	ASSERT_EQ(even.size(), n);
+	for (size_t i = 0; i < n; ++i) {
+		EXPECT_EQ(even[i].value(TactileValue::rawCurrent), 2 * i);
+		EXPECT_EQ(odd[i].value(TactileValue::rawCurrent), 2 * i + 1);
+	}
+
+	// mapping table, updating taxels [1, 4)
+	const uint16_t indices[] = { 9, 0, 4 };
+	even.updateValues(IndexedView<uint16_t>(packet.data() + header, indices, 3), 1);
+	std::vector<float> expected = { 0, 9, 0, 4, 8 };
+	EXPECT_EQ(even.getValues(TactileValue::rawCurrent), expected);
+
+	// views work with standard algorithms relying on random access
+	const StridedView<uint16_t> view(packet.data() + header, 2 * sizeof(uint16_t), n);
+	EXPECT_EQ(*std::prev(view.end()), 8);
+	EXPECT_TRUE(view.end() - 2 < view.end());
+	using Reverse = std::reverse_iterator<StridedView<uint16_t>::const_iterator>;
+	const Reverse rbegin(view.end()), rend(view.begin());
+	EXPECT_EQ(std::vector<uint16_t>(rbegin, rend), std::vector<uint16_t>({ 8, 6, 4, 2, 0 }));
+	EXPECT_EQ(*std::lower_bound(view.begin(), view.end(), 5), 6);
+	const IndexedView<uint16_t> mapped(packet.data() + header, indices, 3);
+	EXPECT_EQ(*std::max_element(mapped.begin(), mapped.end()), 9);
+	auto it = mapped.end();
+	EXPECT_EQ(*--it, 4);
+	EXPECT_EQ((it - 2)[1], 0);
+	EXPECT_TRUE(mapped.begin() <= it && it >= mapped.begin() && !(it > mapped.end()));
+}
+
+TEST(TactileValueArray, updateFrames)
+{
+	const size_t n = 21, stride = 24, frames = 50;
+	std::vector<float> data(frames * stride);
+	for (size_t k = 0; k < data.size(); ++k)
+		data[k] = 10 * sin(0.37 * k);
+
+	auto scale = std::make_shared<PieceWiseLinearCalib>(
+	    PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 10, 1 } }));
+	for (bool calibrated : { false, true }) {
+		TactileValueArray expected(n), actual;
+		actual.updateFrames(data.data(), 0, n);  // initializes array
+		ASSERT_EQ(actual.size(), n);
+		if (calibrated) {
+			for (size_t i = 3; i < 12; ++i) {
+				expected[i].setCalibration(scale);
+				actual[i].setCalibration(scale);
+			}
+		}
+		for (size_t f = 0; f < frames; ++f)
+			expected.updateValues(data.begin() + f * stride, data.begin() + f * stride + n);
+		actual.updateFrames(data.data(), frames, stride);
+
+		for (int m = 0; m <= TactileValue::lastMode; ++m) {
+			const TactileValue::Mode mode = static_cast<TactileValue::Mode>(m);
+			std::vector<float> a = actual.getValues(mode), e = expected.getValues(mode);
+			EXPECT_EQ(memcmp(a.data(), e.data(), n * sizeof(float)), 0)
+			    << TactileValue::getModeName(mode) << (calibrated ? " calibrated" : "");
+		}
+	}
+}
+
+TEST(TactileValueArray, integer_codes)
+{
+	auto lut = std::make_shared<LookupTableCalib>(
+	    PieceWiseLinearCalib(PieceWiseLinearCalib::CalibrationMap({ { 0, 0 }, { 4095, 1 } })));
+	std::vector<uint16_t> codes = { 0, 4095, 2000, 100 };
+	TactileValueArray array(codes.size());
+	array[0].setCalibration(lut);
+	array[1].setCalibration(lut);
+	array[2].setCalibration(lut);
+	array.updateValues(codes);
+	std::vector<float> values = array.getValues(TactileValue::rawCurrent);
+	EXPECT_FLOAT_EQ(values[0], 0);
+	EXPECT_FLOAT_EQ(values[1], 1);
+	EXPECT_FLOAT_EQ(values[2], 2000 / 4095.);
+	EXPECT_FLOAT_EQ(values[3], 100);  // uncalibrated
+
+	std::vector<int16_t> signed_codes = { -1, 4095 };
+	array.updateValues(signed_codes.data(), signed_codes.data() + signed_codes.size(), 2);
+	values = array.getValues(TactileValue::rawCurrent);
+	EXPECT_FLOAT_EQ(values[2], 0);
+	EXPECT_FLOAT_EQ(values[3], 4095);
+
+	// uncalibrated taxels before, between, and after calibrated runs
+	TactileValueArray mixed(5);
+	mixed[1].setCalibration(lut);
+	mixed[3].setCalibration(lut);
+	mixed.updateValues(std::vector<uint16_t>{ 7, 4095, 8, 0, 9 });
+	values = mixed.getValues(TactileValue::rawCurrent);
+	EXPECT_EQ(values, std::vector<float>({ 7, 1, 8, 0, 9 }));
+}
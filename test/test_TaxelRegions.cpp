@@ -0,0 +1,138 @@
+/* ============================================================
+ *
+ * Copyright (C) 2014 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "TaxelRegions.h"
+#include "TactileValueArray.h"
+#include <math.h>
+
+using namespace tactile;
+
+TEST(TaxelRegions, runs)
+{
+	TaxelRegions regions(10);
+	const auto palm = regions.add("palm");
+	const auto tips = regions.add("tips");
+	EXPECT_EQ(regions.add("palm"), palm);
+	EXPECT_EQ(regions.find("tips"), tips);
+	EXPECT_EQ(regions.find("unknown"), 0);
+
+	regions.set(0, 4, palm);
+	regions.set(std::vector<size_t>({ 6, 9 }), tips);
+	regions.set(std::vector<bool>({ false, false, false, true, true }), tips);
+	EXPECT_EQ(regions.count(palm), 3u);
+	EXPECT_EQ(regions.count(tips), 4u);
+	EXPECT_EQ(regions.count(0), 3u);
+
+	const auto &runs = regions.runs();
+	ASSERT_EQ(runs.size(), 6u);
+	EXPECT_EQ(runs[0].end, 3u);
+	EXPECT_EQ(runs[1].index, tips);
+	EXPECT_EQ(runs[1].end, 5u);
+	EXPECT_EQ(runs[5].begin, 9u);
+}
+
+TEST(TaxelRegions, reserve)
+{
+	TaxelRegions regions(10);
+	const auto palm = regions.add("palm");
+	const auto thumb = regions.add("thumb");
+	regions.reserve(100);
+	// runs are rebuilt in place: their buffer is neither reallocated nor grown
+	const auto *runs = regions.runs().data();
+	const size_t capacity = regions.runs().capacity();
+	EXPECT_GE(capacity, 100u);
+
+	regions.resize(100);
+	for (size_t taxel = 0; taxel < 100; ++taxel)  // alternating regions: one run per taxel
+		regions.set(taxel, taxel + 1, taxel % 2 ? palm : thumb);
+	EXPECT_EQ(regions.runs().size(), 100u);
+	regions.resize(50);
+	regions.resize(100);
+
+	EXPECT_EQ(regions.runs().data(), runs);
+	EXPECT_EQ(regions.runs().capacity(), capacity);
+	EXPECT_EQ(regions.runs().size(), 51u);
+	EXPECT_EQ(regions.count(palm), 25u);
+}
+
+TEST(TaxelRegions, accumulate)
+{
+	TactileValueArray array(1000);
+	auto &regions = array.regions();
+	const auto even = regions.add("even"), tail = regions.add("tail");
+	std::vector<bool> mask(array.size());
+	for (size_t i = 0; i < 600; i += 2)
+		mask[i] = true;
+	regions.set(mask, even);
+	regions.set(600, 1000, tail);
+
+	std::vector<float> frame(array.size());
+	for (size_t i = 0; i < frame.size(); ++i)
+		frame[i] = sinf(i) * (i % 3);
+	array.updateValues(frame);
+
+	std::vector<TactileValueArray::Accumulation> results;
+	array.accumulateRegions(TactileValue::rawCurrent, results, false);
+	ASSERT_EQ(results.size(), 3u);
+	for (TaxelRegions::Index r = 0; r < results.size(); ++r) {
+		// compare with accumulation of copied values of region
+		TactileValueArray::vector_data values;
+		for (size_t i = 0; i < frame.size(); ++i)
+			if (regions.index(i) == r) values.push_back(frame[i]);
+		for (int acc = 0; acc < TactileValueArray::NUM_REDUCTIONS; ++acc) {
+			const auto mode = TactileValueArray::AccMode(acc);
+			// summation order differs: a region's runs are reduced separately
+			const float expected = TactileValueArray::accumulate(values, mode, false);
+			EXPECT_NEAR(results[r][mode], expected, 1e-5 * (1 + fabs(expected)))
+			    << regions.name(r) << " " << TactileValueArray::getModeName(mode);
+		}
+	}
+	array.accumulateRegions(TactileValue::rawCurrent, results);
+	EXPECT_FLOAT_EQ(results[tail][TactileValueArray::CountPositive] * 400,
+	                TactileValueArray::accumulate(
+	                    TactileValueArray::vector_data(frame.begin() + 600, frame.end()),
+	                    TactileValueArray::CountPositive, false));
+}
+
+TEST(TaxelRegions, yaml)
+{
+#ifdef HAVE_YAML
+	TactileValueArray array;
+	array.loadRegions("regions.yaml");
+	ASSERT_EQ(array.size(), 10u);
+	const TaxelRegions &regions = array.regions();
+	EXPECT_EQ(regions.numRegions(), 4u);
+	EXPECT_EQ(regions.count(regions.find("palm")), 6u);
+	EXPECT_EQ(regions.index(9), regions.find("tips"));
+	EXPECT_EQ(regions.index(8), regions.find("phalanges"));
+	EXPECT_EQ(regions.count(regions.find("phalanges")), 2u);
+
+	TactileValueArray small(5);
+	EXPECT_THROW(small.loadRegions("regions.yaml"), std::out_of_range);
+#else
+	TactileValueArray array;
+	EXPECT_THROW(array.loadRegions("regions.yaml"), std::runtime_error);
+#endif
+}
@@ -0,0 +1,197 @@
+/* ============================================================
+ *
+ * Copyright (C) 2015 by Robert Haschke <rhaschke at techfak dot uni-bielefeld dot de>
+ *
+ * This file may be licensed under the terms of the
+ * GNU Lesser General Public License Version 3 (the "LGPL"),
+ * or (at your option) any later version.
+ *
+ * Software distributed under the License is distributed
+ * on an ``AS IS'' basis, WITHOUT WARRANTY OF ANY KIND, either
+ * express or implied. See the LGPL for the specific language
+ * governing rights and limitations.
+ *
+ * You should have received a copy of the LGPL along with this
+ * program. If not, go to http://www.gnu.org/licenses/lgpl.html
+ * or write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The development of this software was supported by:
+ *   CITEC, "Cognitive Interaction Technology" Excellence Cluster
+ *     Bielefeld University
+ *
+ * ============================================================ */
+
+#include <gtest/gtest.h>
+#include "UpdateKernel.h"
+#include "TactileValue.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+using namespace tactile;
+
+struct StateBuffer
+{
+	StateBuffer(size_t n) : n(n), storage(TactileState::size(n))
+	{
+		state.bind(storage.data(), n);
+		for (size_t i = 0; i < n; ++i) {
+			state.cur[i] = state.mean[i] = NAN;
+			state.released[i] = FLT_MAX;
+			state.absMin[i] = state.dynMin[i] = FLT_MAX;
+			state.absMax[i] = state.dynMax[i] = -FLT_MAX;
+		}
+		// non-default parameters
+		params.meanLambda = 0.6;
+		params.rangeLambda = 0.9;
+	}
+	bool operator==(const StateBuffer &other) const
+	{
+		return memcmp(storage.data(), other.storage.data(), storage.size() * sizeof(float)) == 0;
+	}
+
+	size_t n;
+	std::vector<float, AlignedAllocator<float>> storage;
+	TactileState state;
+	TactileParams params;
+};
+
+TEST(UpdateKernel, variants_equal_scalar)
+{
+	const UpdateKernel::Isa best = UpdateKernel::best();
+	ASSERT_TRUE(UpdateKernel::supported(UpdateKernel::SCALAR));
+	EXPECT_EQ(UpdateKernel::selected(), best);
+
+	const size_t n = 37;  // not a multiple of the vector width
+	for (int isa = UpdateKernel::SCALAR + 1; isa < UpdateKernel::NUM_ISAS; ++isa) {
+		if (!UpdateKernel::supported(static_cast<UpdateKernel::Isa>(isa))) continue;
+		SCOPED_TRACE(UpdateKernel::getIsaName(static_cast<UpdateKernel::Isa>(isa)));
+
+		StateBuffer expected(n), actual(n);
+		std::vector<float> frame(n, 0.f);
+		srand(1);
+		for (size_t f = 0; f < 500; ++f) {
+			for (size_t i = 0; i < n; ++i) {
+				float r = float(rand()) / RAND_MAX;
+				if (r < 0.01)
+					frame[i] = NAN;
+				else if (r < 0.02)
+					frame[i] = (r < 0.015 ? 1 : -1) * INFINITY;
+				else if (r < 0.1)  // large jumps trigger the release mode
+					frame[i] = 20 * r;
+				else
+					frame[i] = (isfinite(frame[i]) ? frame[i] : 0) + r - 0.6;
+			}
+			ASSERT_TRUE(UpdateKernel::select(UpdateKernel::SCALAR));
+			UpdateKernel::update(expected.state, expected.params, frame.data(), n);
+			ASSERT_TRUE(UpdateKernel::select(static_cast<UpdateKernel::Isa>(isa)));
+			UpdateKernel::update(actual.state, actual.params, frame.data(), n);
+			ASSERT_TRUE(expected == actual) << "frame " << f;
+		}
+		// ensure that release mode was actually exercised
+		size_t released = 0;
+		for (size_t i = 0; i < n; ++i)
+			released += actual.state.released[i] != FLT_MAX;
+		EXPECT_GT(released, 0u);
+	}
+	UpdateKernel::select(best);
+}
+
+TEST(UpdateKernel, frames_equal_single)
+{
+	const size_t n = 37, stride = 40, frames = 300;
+	std::vector<float> data(frames * stride, NAN);
+	srand(2);
+	for (size_t f = 0; f < frames; ++f) {
+		for (size_t i = 0; i < n; ++i) {
+			float r = float(rand()) / RAND_MAX;
+			data[f * stride + i] = r < 0.01 ? NAN : r < 0.1 ? 20 * r : sin(0.1 * f + i) + r;
+		}
+	}
+	for (int isa = UpdateKernel::SCALAR; isa < UpdateKernel::NUM_ISAS; ++isa) {
+		if (!UpdateKernel::select(static_cast<UpdateKernel::Isa>(isa))) continue;
+		SCOPED_TRACE(UpdateKernel::getIsaName(static_cast<UpdateKernel::Isa>(isa)));
+
+		StateBuffer expected(n), actual(n);
+		for (size_t f = 0; f < frames; ++f)
+			UpdateKernel::update(expected.state, expected.params, data.data() + f * stride, n);
+		UpdateKernel::updateFrames(actual.state, actual.params, data.data(), n, frames, stride);
+		EXPECT_TRUE(expected == actual);
+	}
+	UpdateKernel::select(UpdateKernel::best());
+}
+
+static bool same(float a, float b)
+{
+	return a == b || (isnan(a) && isnan(b));
+}
+
+TEST(UpdateKernel, matches_TactileValue)
+{
+	const float values[] = { NAN, 1, 2, INFINITY, 10, 3, 2.5, 2.4, -1, 0.5, NAN, 4 };
+	for (int isa = UpdateKernel::SCALAR; isa < UpdateKernel::NUM_ISAS; ++isa) {
+		if (!UpdateKernel::select(static_cast<UpdateKernel::Isa>(isa))) continue;
+		SCOPED_TRACE(UpdateKernel::getIsaName(static_cast<UpdateKernel::Isa>(isa)));
+
+		// update 16 identical taxels to use the vectorized code path
+		StateBuffer buffer(16);
+		std::vector<float> frame(16);
+		TactileValue expected;
+		expected.setMeanLambda(buffer.params.meanLambda);
+		expected.setRangeLambda(buffer.params.rangeLambda);
+		for (float v : values) {
+			std::fill(frame.begin(), frame.end(), v);
+			UpdateKernel::update(buffer.state, buffer.params, frame.data(), frame.size());
+			expected.update(v);
+			for (size_t i = 0; i < frame.size(); ++i) {
+				EXPECT_EQ(buffer.state.absMin[i], expected.absRange().min());
+				EXPECT_EQ(buffer.state.dynMax[i], expected.dynRange().max());
+				EXPECT_TRUE(same(buffer.state.mean[i], expected.value(TactileValue::rawMean)));
+				EXPECT_TRUE(same(buffer.state.cur[i], expected.value(TactileValue::rawCurrent)));
+			}
+		}
+	}
+	UpdateKernel::select(UpdateKernel::best());
+}
+
+TEST(UpdateKernel, repeated_equals_iterated)
+{
+	// histories ending in and outside of release mode
+	const std::vector<std::vector<float>> histories = { { 0, 1, 2, 1.5 }, { 0, 10, 10, 2 } };
+	for (const auto &history : histories) {
+		for (unsigned int k : { 1u, 2u, 10u, 1000u }) {
+			for (float x : { history.back(), 3.f }) {
+				TactileValue iterated, closed;
+				iterated.setRangeLambda(0.99);
+				closed.setRangeLambda(0.99);
+				StateBuffer buffer(1);
+				buffer.params.meanLambda = closed.getMeanLambda();
+				buffer.params.rangeLambda = closed.getRangeLambda();
+				for (float v : history) {
+					iterated.update(v);
+					closed.update(v);
+					UpdateKernel::update(buffer.state, buffer.params, &v, 1);
+				}
+				for (unsigned int j = 0; j < k; ++j)
+					iterated.update(x);
+				closed.update(x, k);
+				UpdateKernel::updateRepeated(buffer.state, buffer.params, 0, x, k);
+
+				SCOPED_TRACE(testing::Message() << "k = " << k << ", x = " << x);
+				EXPECT_EQ(closed.value(TactileValue::rawCurrent), x);
+				EXPECT_NEAR(closed.value(TactileValue::rawMean), iterated.value(TactileValue::rawMean),
+				            1e-5);
+				EXPECT_NEAR(closed.dynRange().min(), iterated.dynRange().min(), 1e-4);
+				EXPECT_NEAR(closed.dynRange().max(), iterated.dynRange().max(), 1e-4);
+				// normalization by the (strongly shrunk) range amplifies rounding differences
+				EXPECT_NEAR(closed.value(TactileValue::dynCurrentRelease),
+				            iterated.value(TactileValue::dynCurrentRelease), k < 1000 ? 1e-3 : 1e-2);
+				EXPECT_EQ(buffer.state.released[0] == FLT_MAX,
+				          iterated.value(TactileValue::dynCurrentRelease) >= 0);
+				EXPECT_EQ(buffer.state.dynMin[0], closed.dynRange().min());
+				EXPECT_EQ(buffer.state.mean[0], closed.value(TactileValue::rawMean));
+			}
+		}
+	}
+}